@@ -0,0 +1,181 @@
+//
+// SprintTrace: region-based bump allocator
+// Copyright 2022, Laminoid.com (Muessig & Muessig GbR).
+// Licensed under the terms and conditions of the GPLv3.
+//
+
+#include "arena.h"
+#include "errors.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+#ifndef WIN32
+#include <sys/mman.h>
+#endif
+
+const size_t SPRINT_ARENA_BLOCK_SIZE = 2 * 1024 * 1024;
+const size_t SPRINT_ARENA_ALIGNMENT = 16;
+
+struct sprint_arena_block {
+    // The block that was allocated from before this one
+    sprint_arena_block* previous;
+
+    // The total size of the block, including this header
+    size_t size;
+
+    // The offset of the free memory inside the block
+    size_t used;
+
+    // Whether the block has been mapped instead of allocated
+    bool mapped;
+};
+
+static size_t sprint_arena_align_internal(size_t size);
+static sprint_arena_block* sprint_arena_block_create_internal(sprint_arena* arena, size_t size);
+static void sprint_arena_block_destroy_internal(sprint_arena_block* block);
+
+sprint_arena* sprint_arena_create(bool huge)
+{
+    sprint_arena* arena = calloc(1, sizeof(*arena));
+    if (arena == NULL)
+        return NULL;
+
+    arena->huge = huge;
+    return arena;
+}
+
+void* sprint_arena_alloc(sprint_arena* arena, size_t size)
+{
+    if (arena == NULL) return NULL;
+
+    // Keep every allocation aligned, also allocating something for empty ones
+    size_t aligned = sprint_arena_align_internal(size > 0 ? size : 1);
+    if (aligned < size)
+        return NULL;
+
+    // Start a new block, if the current one is too full
+    sprint_arena_block* block = arena->block;
+    if (block == NULL || block->size - block->used < aligned) {
+        // Large allocations get a block of their own, which is put behind the current one to keep filling it
+        size_t header = sprint_arena_align_internal(sizeof(sprint_arena_block));
+        bool large = aligned > SPRINT_ARENA_BLOCK_SIZE / 4;
+        block = sprint_arena_block_create_internal(arena, large ? header + aligned : SPRINT_ARENA_BLOCK_SIZE);
+        if (block == NULL)
+            return NULL;
+        if (large && arena->block != NULL) {
+            block->previous = arena->block->previous;
+            arena->block->previous = block;
+        } else {
+            block->previous = arena->block;
+            arena->block = block;
+        }
+    }
+
+    // Bump the offset
+    void* memory = (char*) block + block->used;
+    block->used += aligned;
+    arena->used += aligned;
+    return memory;
+}
+
+sprint_error sprint_arena_merge(sprint_arena* arena, sprint_arena* source)
+{
+    if (arena == NULL || source == NULL) return SPRINT_ERROR_ARGUMENT_NULL;
+    if (arena == source) return SPRINT_ERROR_ARGUMENT_RANGE;
+
+    // Link the blocks of the source behind the current block, so that it keeps being allocated from
+    if (source->block != NULL) {
+        sprint_arena_block* oldest = source->block;
+        while (oldest->previous != NULL)
+            oldest = oldest->previous;
+        if (arena->block != NULL) {
+            oldest->previous = arena->block->previous;
+            arena->block->previous = source->block;
+        } else
+            arena->block = source->block;
+    }
+    arena->used += source->used;
+    arena->reserved += source->reserved;
+
+    // The blocks are owned by the arena now, so only free the source itself
+    free(source);
+    return SPRINT_ERROR_NONE;
+}
+
+size_t sprint_arena_used(sprint_arena* arena)
+{
+    return arena == NULL ? 0 : arena->used;
+}
+
+size_t sprint_arena_reserved(sprint_arena* arena)
+{
+    return arena == NULL ? 0 : arena->reserved;
+}
+
+sprint_error sprint_arena_destroy(sprint_arena* arena)
+{
+    if (arena == NULL) return SPRINT_ERROR_ARGUMENT_NULL;
+
+    // Release all blocks
+    while (arena->block != NULL) {
+        sprint_arena_block* block = arena->block;
+        arena->block = block->previous;
+        sprint_arena_block_destroy_internal(block);
+    }
+
+    free(arena);
+    return SPRINT_ERROR_NONE;
+}
+
+size_t sprint_arena_align_internal(size_t size)
+{
+    return (size + SPRINT_ARENA_ALIGNMENT - 1) & ~(SPRINT_ARENA_ALIGNMENT - 1);
+}
+
+sprint_arena_block* sprint_arena_block_create_internal(sprint_arena* arena, size_t size)
+{
+    sprint_arena_block* block = NULL;
+    bool mapped = false;
+
+#if defined(MADV_HUGEPAGE) && defined(MAP_ANONYMOUS)
+    // Map huge blocks directly, rounded up to whole huge pages, and ask for them to be backed by huge pages
+    if (arena->huge) {
+        size_t huge_size = (size + SPRINT_ARENA_BLOCK_SIZE - 1) / SPRINT_ARENA_BLOCK_SIZE * SPRINT_ARENA_BLOCK_SIZE;
+        void* address = mmap(NULL, huge_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (address != MAP_FAILED) {
+            madvise(address, huge_size, MADV_HUGEPAGE);
+            block = address;
+            size = huge_size;
+            mapped = true;
+        }
+    }
+#endif
+
+    // Otherwise, allocate the block regularly
+    if (block == NULL) {
+        block = malloc(size);
+        if (block == NULL)
+            return NULL;
+    }
+
+    // Initialize the header and start allocating right after it
+    block->previous = NULL;
+    block->size = size;
+    block->used = sprint_arena_align_internal(sizeof(sprint_arena_block));
+    block->mapped = mapped;
+    arena->reserved += size;
+    return block;
+}
+
+void sprint_arena_block_destroy_internal(sprint_arena_block* block)
+{
+#if defined(MADV_HUGEPAGE) && defined(MAP_ANONYMOUS)
+    if (block->mapped) {
+        munmap(block, block->size);
+        return;
+    }
+#endif
+    free(block);
+}
@@ -0,0 +1,57 @@
+//
+// SprintTrace: region-based bump allocator
+// Copyright 2022, Laminoid.com (Muessig & Muessig GbR).
+// Licensed under the terms and conditions of the GPLv3.
+//
+
+#ifndef SPRINTTRACE_ARENA_H
+#define SPRINTTRACE_ARENA_H
+
+#include "errors.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+extern const size_t SPRINT_ARENA_BLOCK_SIZE;
+extern const size_t SPRINT_ARENA_ALIGNMENT;
+
+typedef struct sprint_arena_block sprint_arena_block;
+
+// Represents a region of memory that is allocated from in order and released at once
+typedef struct sprint_arena {
+    // The block that is currently allocated from, which links to all previous blocks
+    sprint_arena_block* block;
+
+    // Whether the blocks should be backed by huge pages, if supported
+    bool huge;
+
+    // The number of bytes allocated and reserved by all blocks
+    size_t used;
+    size_t reserved;
+} sprint_arena;
+
+/**
+ * Creates an arena, which reserves its memory in blocks as allocations are made.
+ * @param huge Whether to request huge pages for the blocks, which is only a hint.
+ * @return The arena, or null if it could not be allocated.
+ */
+sprint_arena* sprint_arena_create(bool huge);
+/**
+ * Allocates uninitialized memory from the arena, which remains valid until the arena is destroyed.
+ * @param arena The arena instance.
+ * @param size The number of bytes to allocate.
+ * @return The memory aligned for any type, or null if it could not be allocated.
+ */
+void* sprint_arena_alloc(sprint_arena* arena, size_t size);
+/**
+ * Moves all memory of another arena into the arena, so that it is released together with it.
+ * @param arena The arena instance.
+ * @param source The arena to move the memory of, which is destroyed.
+ * @return No error returned on success.
+ */
+sprint_error sprint_arena_merge(sprint_arena* arena, sprint_arena* source);
+size_t sprint_arena_used(sprint_arena* arena);
+size_t sprint_arena_reserved(sprint_arena* arena);
+sprint_error sprint_arena_destroy(sprint_arena* arena);
+
+#endif //SPRINTTRACE_ARENA_H
@@ -7,6 +7,7 @@
 #include "elements.h"
 #include "primitives.h"
 #include "token.h"
+#include "keyword.h"
 #include "output.h"
 #include "errors.h"
 
@@ -66,35 +67,53 @@ bool sprint_element_type_from_keyword(sprint_element_type* type, bool* closing,
 {
     if (type == NULL || closing == NULL || keyword == NULL) return false;
 
+    return sprint_element_type_from_keyword_id(type, closing, sprint_keyword_of(keyword, (int) strlen(keyword)));
+}
+
+bool sprint_element_type_from_keyword_id(sprint_element_type* type, bool* closing, sprint_keyword keyword)
+{
+    if (type == NULL || closing == NULL) return false;
+
     // Preset closing to false
     *closing = false;
 
     // Determine the type
-    if (strcasecmp(keyword, sprint_element_type_to_keyword(SPRINT_ELEMENT_TRACK, false)) == 0)
-        *type = SPRINT_ELEMENT_TRACK;
-    else if (strcasecmp(keyword, sprint_element_type_to_keyword(SPRINT_ELEMENT_PAD_THT, false)) == 0)
-        *type = SPRINT_ELEMENT_PAD_THT;
-    else if (strcasecmp(keyword, sprint_element_type_to_keyword(SPRINT_ELEMENT_PAD_SMT, false)) == 0)
-        *type = SPRINT_ELEMENT_PAD_SMT;
-    else if (strcasecmp(keyword, sprint_element_type_to_keyword(SPRINT_ELEMENT_ZONE, false)) == 0)
-        *type = SPRINT_ELEMENT_ZONE;
-    else if (strcasecmp(keyword, sprint_element_type_to_keyword(SPRINT_ELEMENT_TEXT, false)) == 0)
-        *type = SPRINT_ELEMENT_TEXT;
-    else if (strcasecmp(keyword, sprint_element_type_to_keyword(SPRINT_ELEMENT_CIRCLE, false)) == 0)
-        *type = SPRINT_ELEMENT_CIRCLE;
-    else if (strcasecmp(keyword, sprint_element_type_to_keyword(SPRINT_ELEMENT_COMPONENT, false)) == 0)
-        *type = SPRINT_ELEMENT_COMPONENT;
-    else if (strcasecmp(keyword, sprint_element_type_to_keyword(SPRINT_ELEMENT_GROUP, false)) == 0)
-        *type = SPRINT_ELEMENT_GROUP;
-    else if (strcasecmp(keyword, sprint_element_type_to_keyword(SPRINT_ELEMENT_COMPONENT, true)) == 0) {
-        *closing = true;
-        *type = SPRINT_ELEMENT_COMPONENT;
-    }
-    else if (strcasecmp(keyword, sprint_element_type_to_keyword(SPRINT_ELEMENT_GROUP, true)) == 0) {
-        *closing = true;
-        *type = SPRINT_ELEMENT_GROUP;
-    } else
-        return false;
+    switch (keyword) {
+        case SPRINT_KEYWORD_TRACK:
+            *type = SPRINT_ELEMENT_TRACK;
+            break;
+        case SPRINT_KEYWORD_PAD:
+            *type = SPRINT_ELEMENT_PAD_THT;
+            break;
+        case SPRINT_KEYWORD_SMDPAD:
+            *type = SPRINT_ELEMENT_PAD_SMT;
+            break;
+        case SPRINT_KEYWORD_ZONE:
+            *type = SPRINT_ELEMENT_ZONE;
+            break;
+        case SPRINT_KEYWORD_TEXT:
+            *type = SPRINT_ELEMENT_TEXT;
+            break;
+        case SPRINT_KEYWORD_CIRCLE:
+            *type = SPRINT_ELEMENT_CIRCLE;
+            break;
+        case SPRINT_KEYWORD_BEGIN_COMPONENT:
+            *type = SPRINT_ELEMENT_COMPONENT;
+            break;
+        case SPRINT_KEYWORD_GROUP:
+            *type = SPRINT_ELEMENT_GROUP;
+            break;
+        case SPRINT_KEYWORD_END_COMPONENT:
+            *closing = true;
+            *type = SPRINT_ELEMENT_COMPONENT;
+            break;
+        case SPRINT_KEYWORD_END_GROUP:
+            *closing = true;
+            *type = SPRINT_ELEMENT_GROUP;
+            break;
+        default:
+            return false;
+    }
 
     return true;
 }
@@ -444,15 +463,27 @@ bool sprint_text_type_from_keyword(sprint_text_type* type, const char* keyword)
 {
     if (type == NULL || keyword == NULL) return false;
 
+    return sprint_text_type_from_keyword_id(type, sprint_keyword_of(keyword, (int) strlen(keyword)));
+}
+
+bool sprint_text_type_from_keyword_id(sprint_text_type* type, sprint_keyword keyword)
+{
+    if (type == NULL) return false;
+
     // Determine the type
-    if (strcasecmp(keyword, sprint_text_type_to_keyword(SPRINT_TEXT_REGULAR)) == 0)
-        *type = SPRINT_TEXT_REGULAR;
-    else if (strcasecmp(keyword, sprint_text_type_to_keyword(SPRINT_TEXT_ID)) == 0)
-        *type = SPRINT_TEXT_ID;
-    else if (strcasecmp(keyword, sprint_text_type_to_keyword(SPRINT_TEXT_VALUE)) == 0)
-        *type = SPRINT_TEXT_VALUE;
-    else
-        return false;
+    switch (keyword) {
+        case SPRINT_KEYWORD_TEXT:
+            *type = SPRINT_TEXT_REGULAR;
+            break;
+        case SPRINT_KEYWORD_ID_TEXT:
+            *type = SPRINT_TEXT_ID;
+            break;
+        case SPRINT_KEYWORD_VALUE_TEXT:
+            *type = SPRINT_TEXT_VALUE;
+            break;
+        default:
+            return false;
+    }
 
     return true;
 }
@@ -759,10 +790,13 @@ sprint_error sprint_group_create(sprint_element* element, int num_elements, spri
 
 static sprint_error sprint_indent_output_internal(sprint_output* output, int depth)
 {
+    // Put the indentation in as few pieces as possible
+    static const char spaces[] = "                                                                ";
     sprint_error error = SPRINT_ERROR_NONE;
-    for (depth--; depth >= 0; depth--)
-        for (int indent = 0; indent < SPRINT_ELEMENT_INDENT; indent++)
-            sprint_chain(error, sprint_output_put_chr(output, ' '));
+    for (int indent = depth * SPRINT_ELEMENT_INDENT; indent > 0; indent -= (int) sizeof(spaces) - 1) {
+        size_t length = (size_t) indent < sizeof(spaces) - 1 ? (size_t) indent : sizeof(spaces) - 1;
+        sprint_chain(error, sprint_output_put_bytes(output, spaces, length));
+    }
     return sprint_rethrow(error);
 }
 
@@ -1303,7 +1337,7 @@ bool sprint_element_valid(sprint_element* element)
 
 #pragma clang diagnostic push
 #pragma ide diagnostic ignored "misc-no-recursion"
-static sprint_error sprint_element_destroy_internal(sprint_element* element, int depth)
+static sprint_error sprint_element_destroy_internal(sprint_element* element, bool allocated, int depth)
 {
     // Make sure the element is not null
     if (element == NULL) return SPRINT_ERROR_ARGUMENT_NULL;
@@ -1313,6 +1347,10 @@ static sprint_error sprint_element_destroy_internal(sprint_element* element, int
     if (!element->parsed)
         return SPRINT_ERROR_NONE;
 
+    // Elements from an arena are only released together with all others in it
+    if (element->pooled)
+        return SPRINT_ERROR_NONE;
+
     // Free allocated memory based on the type
     sprint_error first_error = SPRINT_ERROR_NONE, last_error = SPRINT_ERROR_NONE;
     switch (element->type) {
@@ -1396,14 +1434,14 @@ static sprint_error sprint_element_destroy_internal(sprint_element* element, int
         case SPRINT_ELEMENT_COMPONENT:
             // Free the ID text
             if (element->component.text_id != NULL) {
-                sprint_check(last_error = sprint_element_destroy_internal(element->component.text_id, depth + 1));
+                sprint_check(last_error = sprint_element_destroy_internal(element->component.text_id, true, depth + 1));
                 first_error = last_error;
                 element->component.text_id = NULL;
             }
 
             // Free the value text
             if (element->component.text_value != NULL) {
-                sprint_check(last_error = sprint_element_destroy_internal(element->component.text_value, depth + 1));
+                sprint_check(last_error = sprint_element_destroy_internal(element->component.text_value, true, depth + 1));
                 first_error = first_error == SPRINT_ERROR_NONE ? last_error : first_error;
                 element->component.text_value = NULL;
             }
@@ -1411,7 +1449,7 @@ static sprint_error sprint_element_destroy_internal(sprint_element* element, int
             // Free the elements recursively
             if (element->component.elements != NULL) {
                 for (int index = 0; index < element->component.num_elements; index++) {
-                    sprint_check(last_error = sprint_element_destroy_internal(&element->component.elements[index], depth + 1));
+                    sprint_check(last_error = sprint_element_destroy_internal(&element->component.elements[index], false, depth + 1));
                     first_error = first_error == SPRINT_ERROR_NONE ? last_error : first_error;
                 }
                 free(element->component.elements);
@@ -1436,7 +1474,7 @@ static sprint_error sprint_element_destroy_internal(sprint_element* element, int
             // Free the elements recursively
             if (element->group.elements != NULL) {
                 for (int index = 0; index < element->group.num_elements; index++) {
-                    sprint_check(last_error = sprint_element_destroy_internal(&element->group.elements[index], depth + 1));
+                    sprint_check(last_error = sprint_element_destroy_internal(&element->group.elements[index], false, depth + 1));
                     first_error = first_error == SPRINT_ERROR_NONE ? last_error : first_error;
                 }
                 free(element->group.elements);
@@ -1451,13 +1489,19 @@ static sprint_error sprint_element_destroy_internal(sprint_element* element, int
             return SPRINT_ERROR_ARGUMENT_RANGE;
     }
 
-    // Finally, free the parsed element
-    free(element);
+    // Finally, free the parsed element, unless it is stored inside the array of its parent
+    if (allocated)
+        free(element);
     return sprint_rethrow(first_error);
 }
 #pragma clang diagnostic pop
 
 sprint_error sprint_element_destroy(sprint_element* element)
 {
-    return sprint_element_destroy_internal(element, 0);
+    return sprint_element_destroy_internal(element, true, 0);
+}
+
+sprint_error sprint_element_destroy_contents(sprint_element* element)
+{
+    return sprint_element_destroy_internal(element, false, 0);
 }
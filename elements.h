@@ -9,6 +9,7 @@
 
 #include "primitives.h"
 #include "output.h"
+#include "keyword.h"
 #include "errors.h"
 
 #include <stdbool.h>
@@ -88,16 +89,16 @@ typedef struct sprint_pad_tht {
     sprint_dist drill;
     sprint_pad_tht_form form;
 
-    // Optional
+    // Optional, ordered by size, since this is the largest element that determines the size of all others
 
     sprint_link link;
     sprint_dist clear;
-    bool soldermask;
     sprint_angle rotation;
-    bool via;
-    bool thermal;
     int thermal_tracks;
     int thermal_tracks_width;
+    bool soldermask;
+    bool via;
+    bool thermal;
     bool thermal_tracks_individual;
     char* name;
 } sprint_pad_tht;
@@ -147,6 +148,7 @@ extern const char* SPRINT_TEXT_TYPE_KEYWORDS[];
 bool sprint_text_type_valid(sprint_text_type type);
 const char* sprint_text_type_to_keyword(sprint_text_type type);
 bool sprint_text_type_from_keyword(sprint_text_type* type, const char* keyword);
+bool sprint_text_type_from_keyword_id(sprint_text_type* type, sprint_keyword keyword);
 sprint_error sprint_text_type_output(sprint_text_type type, sprint_output* output, sprint_prim_format format);
 
 typedef enum sprint_text_style {
@@ -254,6 +256,9 @@ struct sprint_element {
     // Whether the element has been created by parsing, which uses malloc for all buffers
     bool parsed;
 
+    // Whether the parsed element and its buffers have been allocated from an arena instead, which releases them
+    bool pooled;
+
     union {
         sprint_track track;
         sprint_pad_tht pad_tht;
@@ -271,6 +276,7 @@ extern const char* SPRINT_ELEMENT_TYPE_KEYWORDS_OPENING[];
 extern const char* SPRINT_ELEMENT_TYPE_KEYWORDS_CLOSING[];
 const char* sprint_element_type_to_keyword(sprint_element_type type, bool closing);
 bool sprint_element_type_from_keyword(sprint_element_type* type, bool* closing, const char* keyword);
+bool sprint_element_type_from_keyword_id(sprint_element_type* type, bool* closing, sprint_keyword keyword);
 sprint_error sprint_element_type_output(sprint_element_type type, sprint_output* output, bool closing,
                                         sprint_prim_format format);
 
@@ -302,5 +308,11 @@ const char* sprint_element_tag(sprint_element* element);
 sprint_error sprint_element_output(sprint_element* element, sprint_output* output, sprint_prim_format format);
 bool sprint_element_valid(sprint_element* element);
 sprint_error sprint_element_destroy(sprint_element* element);
+/**
+ * Frees the buffers of a parsed element, but not the element itself, which is stored inside an array.
+ * @param element The element to free the buffers of.
+ * @return No error returned on success.
+ */
+sprint_error sprint_element_destroy_contents(sprint_element* element);
 
 #endif //SPRINTTRACE_ELEMENTS_H
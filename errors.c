@@ -36,6 +36,9 @@ const char* SPRINT_ERROR_NAMES[] = {
         [SPRINT_ERROR_PLUGIN_FLAGS_SYNTAX] = "plugin flags syntax"
 };
 
+// Whether diagnostics are muted on the current thread, so that threads doing tentative work do not affect others
+static __thread bool sprint_error_muted = false;
+
 sprint_error sprint_rethrow(sprint_error error)
 {
     switch (error) {
@@ -96,8 +99,22 @@ bool sprint_error_print(sprint_error error, FILE* stream, bool capitalized)
     return fputs(str, stream) != EOF;
 }
 
+bool sprint_error_mute(bool muted)
+{
+    bool previous = sprint_error_muted;
+    sprint_error_muted = muted;
+    return previous;
+}
+
+bool sprint_error_is_muted(void)
+{
+    return sprint_error_muted;
+}
+
 void sprint_debug_internal(const char* file, int line, const char* context)
 {
+    if (sprint_error_muted) return;
+
     const char* state = SPRINT_PLUGIN_STATE_NAMES[sprint_plugin_get_state()];
     fprintf(stderr, "Debug [%s, %s:%d]", state, file == NULL ? "" : file, line);
 
@@ -112,6 +129,8 @@ void sprint_debug_internal(const char* file, int line, const char* context)
 
 void sprint_warning_internal(const char* file, int line, const char* context)
 {
+    if (sprint_error_muted) return;
+
     const char* state = SPRINT_PLUGIN_STATE_NAMES[sprint_plugin_get_state()];
     fprintf(stderr, "Warning [%s, %s:%d]", state, file == NULL ? "" : file, line);
 
@@ -127,6 +146,7 @@ void sprint_warning_internal(const char* file, int line, const char* context)
 bool sprint_error_internal(sprint_error error, bool critical, const char* file, int line, const char* context)
 {
     if (error == SPRINT_ERROR_NONE) return true;
+    if (sprint_error_muted && !critical) return false;
 
     if (critical)
         fputs("Critical ", stderr);
@@ -156,6 +176,7 @@ bool sprint_error_internal(sprint_error error, bool critical, const char* file,
 bool sprint_log(const char* what)
 {
     if (what == NULL) return false;
+    if (sprint_error_muted) return true;
 
     bool success = true;
     success &= fputs(what, stderr) != EOF;
@@ -166,6 +187,7 @@ bool sprint_log(const char* what)
 bool sprint_log_format(const char* format, ...)
 {
     if (format == NULL) return false;
+    if (sprint_error_muted) return true;
 
     bool success = true;
     va_list args;
@@ -41,6 +41,18 @@ extern const char* SPRINT_ERROR_NAMES[];
 
 const char* sprint_error_string(sprint_error error);
 bool sprint_error_print(sprint_error error, FILE* stream, bool capitalized);
+/**
+ * Mutes or unmutes all diagnostics of the calling thread except for critical errors,
+ * e.g. while the results of a computation are tentative.
+ * @param muted Whether to mute the diagnostics.
+ * @return Whether the diagnostics were muted before.
+ */
+bool sprint_error_mute(bool muted);
+/**
+ * Checks whether diagnostics of the calling thread are muted, so that assembling them can be skipped.
+ * @return Whether the diagnostics are muted.
+ */
+bool sprint_error_is_muted(void);
 
 void sprint_debug_internal(const char* file, int line, const char* context);
 void sprint_warning_internal(const char* file, int line, const char* context);
@@ -0,0 +1,151 @@
+//
+// SprintTrace: keyword recognition
+// Copyright 2022, Laminoid.com (Muessig & Muessig GbR).
+// Licensed under the terms and conditions of the GPLv3.
+//
+
+#include "keyword.h"
+
+#include <stdbool.h>
+#include <string.h>
+
+const char* SPRINT_KEYWORD_NAMES[] = {
+        [SPRINT_KEYWORD_UNKNOWN] = "",
+        [SPRINT_KEYWORD_TRACK] = "TRACK",
+        [SPRINT_KEYWORD_PAD] = "PAD",
+        [SPRINT_KEYWORD_SMDPAD] = "SMDPAD",
+        [SPRINT_KEYWORD_ZONE] = "ZONE",
+        [SPRINT_KEYWORD_TEXT] = "TEXT",
+        [SPRINT_KEYWORD_CIRCLE] = "CIRCLE",
+        [SPRINT_KEYWORD_BEGIN_COMPONENT] = "BEGIN_COMPONENT",
+        [SPRINT_KEYWORD_END_COMPONENT] = "END_COMPONENT",
+        [SPRINT_KEYWORD_GROUP] = "GROUP",
+        [SPRINT_KEYWORD_END_GROUP] = "END_GROUP",
+        [SPRINT_KEYWORD_ID_TEXT] = "ID_TEXT",
+        [SPRINT_KEYWORD_VALUE_TEXT] = "VALUE_TEXT",
+        [SPRINT_KEYWORD_CENTER] = "CENTER",
+        [SPRINT_KEYWORD_CLEAR] = "CLEAR",
+        [SPRINT_KEYWORD_COMMENT] = "COMMENT",
+        [SPRINT_KEYWORD_CON] = "CON",
+        [SPRINT_KEYWORD_CUTOUT] = "CUTOUT",
+        [SPRINT_KEYWORD_DRILL] = "DRILL",
+        [SPRINT_KEYWORD_FILL] = "FILL",
+        [SPRINT_KEYWORD_FLATEND] = "FLATEND",
+        [SPRINT_KEYWORD_FLATSTART] = "FLATSTART",
+        [SPRINT_KEYWORD_FORM] = "FORM",
+        [SPRINT_KEYWORD_HATCH] = "HATCH",
+        [SPRINT_KEYWORD_HATCH_AUTO] = "HATCH_AUTO",
+        [SPRINT_KEYWORD_HATCH_WIDTH] = "HATCH_WIDTH",
+        [SPRINT_KEYWORD_HEIGHT] = "HEIGHT",
+        [SPRINT_KEYWORD_LAYER] = "LAYER",
+        [SPRINT_KEYWORD_MIRROR_HORZ] = "MIRROR_HORZ",
+        [SPRINT_KEYWORD_MIRROR_VERT] = "MIRROR_VERT",
+        [SPRINT_KEYWORD_NAME] = "NAME",
+        [SPRINT_KEYWORD_P] = "P",
+        [SPRINT_KEYWORD_PACKAGE] = "PACKAGE",
+        [SPRINT_KEYWORD_PAD_ID] = "PAD_ID",
+        [SPRINT_KEYWORD_POS] = "POS",
+        [SPRINT_KEYWORD_RADIUS] = "RADIUS",
+        [SPRINT_KEYWORD_ROTATION] = "ROTATION",
+        [SPRINT_KEYWORD_SIZE] = "SIZE",
+        [SPRINT_KEYWORD_SIZE_X] = "SIZE_X",
+        [SPRINT_KEYWORD_SIZE_Y] = "SIZE_Y",
+        [SPRINT_KEYWORD_SOLDERMASK] = "SOLDERMASK",
+        [SPRINT_KEYWORD_SOLDERMASK_CUTOUT] = "SOLDERMASK_CUTOUT",
+        [SPRINT_KEYWORD_START] = "START",
+        [SPRINT_KEYWORD_STOP] = "STOP",
+        [SPRINT_KEYWORD_STYLE] = "STYLE",
+        [SPRINT_KEYWORD_THERMAL] = "THERMAL",
+        [SPRINT_KEYWORD_THERMAL_TRACKS] = "THERMAL_TRACKS",
+        [SPRINT_KEYWORD_THERMAL_TRACKS_INDIVIDUAL] = "THERMAL_TRACKS_INDIVIDUAL",
+        [SPRINT_KEYWORD_THERMAL_TRACKS_WIDTH] = "THERMAL_TRACKS_WIDTH",
+        [SPRINT_KEYWORD_THICKNESS] = "THICKNESS",
+        [SPRINT_KEYWORD_USE_PICKPLACE] = "USE_PICKPLACE",
+        [SPRINT_KEYWORD_VIA] = "VIA",
+        [SPRINT_KEYWORD_VISIBLE] = "VISIBLE",
+        [SPRINT_KEYWORD_WIDTH] = "WIDTH"
+};
+
+// Hashes the length and the first, middle and last upper-case characters, which is collision-free for all keywords
+#define SPRINT_KEYWORD_HASH(length, first, middle, last) \
+    (((length) + (first) * 3 + (middle) * 10 + (last) * 6) & 0xFF)
+#define SPRINT_KEYWORD_ENTRY(keyword, length, first, middle, last) \
+    [SPRINT_KEYWORD_HASH(length, first, middle, last)] = SPRINT_KEYWORD_##keyword
+
+// The keyword for every hash, which must be kept in sync with the names
+static const unsigned char SPRINT_KEYWORD_TABLE[256] = {
+        SPRINT_KEYWORD_ENTRY(TRACK, 5, 'T', 'A', 'K'),
+        SPRINT_KEYWORD_ENTRY(PAD, 3, 'P', 'A', 'D'),
+        SPRINT_KEYWORD_ENTRY(SMDPAD, 6, 'S', 'P', 'D'),
+        SPRINT_KEYWORD_ENTRY(ZONE, 4, 'Z', 'N', 'E'),
+        SPRINT_KEYWORD_ENTRY(TEXT, 4, 'T', 'X', 'T'),
+        SPRINT_KEYWORD_ENTRY(CIRCLE, 6, 'C', 'C', 'E'),
+        SPRINT_KEYWORD_ENTRY(BEGIN_COMPONENT, 15, 'B', 'O', 'T'),
+        SPRINT_KEYWORD_ENTRY(END_COMPONENT, 13, 'E', 'M', 'T'),
+        SPRINT_KEYWORD_ENTRY(GROUP, 5, 'G', 'O', 'P'),
+        SPRINT_KEYWORD_ENTRY(END_GROUP, 9, 'E', 'G', 'P'),
+        SPRINT_KEYWORD_ENTRY(ID_TEXT, 7, 'I', 'T', 'T'),
+        SPRINT_KEYWORD_ENTRY(VALUE_TEXT, 10, 'V', '_', 'T'),
+        SPRINT_KEYWORD_ENTRY(CENTER, 6, 'C', 'T', 'R'),
+        SPRINT_KEYWORD_ENTRY(CLEAR, 5, 'C', 'E', 'R'),
+        SPRINT_KEYWORD_ENTRY(COMMENT, 7, 'C', 'M', 'T'),
+        SPRINT_KEYWORD_ENTRY(CON, 3, 'C', 'O', 'N'),
+        SPRINT_KEYWORD_ENTRY(CUTOUT, 6, 'C', 'O', 'T'),
+        SPRINT_KEYWORD_ENTRY(DRILL, 5, 'D', 'I', 'L'),
+        SPRINT_KEYWORD_ENTRY(FILL, 4, 'F', 'L', 'L'),
+        SPRINT_KEYWORD_ENTRY(FLATEND, 7, 'F', 'T', 'D'),
+        SPRINT_KEYWORD_ENTRY(FLATSTART, 9, 'F', 'S', 'T'),
+        SPRINT_KEYWORD_ENTRY(FORM, 4, 'F', 'R', 'M'),
+        SPRINT_KEYWORD_ENTRY(HATCH, 5, 'H', 'T', 'H'),
+        SPRINT_KEYWORD_ENTRY(HATCH_AUTO, 10, 'H', '_', 'O'),
+        SPRINT_KEYWORD_ENTRY(HATCH_WIDTH, 11, 'H', '_', 'H'),
+        SPRINT_KEYWORD_ENTRY(HEIGHT, 6, 'H', 'G', 'T'),
+        SPRINT_KEYWORD_ENTRY(LAYER, 5, 'L', 'Y', 'R'),
+        SPRINT_KEYWORD_ENTRY(MIRROR_HORZ, 11, 'M', 'R', 'Z'),
+        SPRINT_KEYWORD_ENTRY(MIRROR_VERT, 11, 'M', 'R', 'T'),
+        SPRINT_KEYWORD_ENTRY(NAME, 4, 'N', 'M', 'E'),
+        SPRINT_KEYWORD_ENTRY(P, 1, 'P', 'P', 'P'),
+        SPRINT_KEYWORD_ENTRY(PACKAGE, 7, 'P', 'K', 'E'),
+        SPRINT_KEYWORD_ENTRY(PAD_ID, 6, 'P', '_', 'D'),
+        SPRINT_KEYWORD_ENTRY(POS, 3, 'P', 'O', 'S'),
+        SPRINT_KEYWORD_ENTRY(RADIUS, 6, 'R', 'I', 'S'),
+        SPRINT_KEYWORD_ENTRY(ROTATION, 8, 'R', 'T', 'N'),
+        SPRINT_KEYWORD_ENTRY(SIZE, 4, 'S', 'Z', 'E'),
+        SPRINT_KEYWORD_ENTRY(SIZE_X, 6, 'S', 'E', 'X'),
+        SPRINT_KEYWORD_ENTRY(SIZE_Y, 6, 'S', 'E', 'Y'),
+        SPRINT_KEYWORD_ENTRY(SOLDERMASK, 10, 'S', 'R', 'K'),
+        SPRINT_KEYWORD_ENTRY(SOLDERMASK_CUTOUT, 17, 'S', 'S', 'T'),
+        SPRINT_KEYWORD_ENTRY(START, 5, 'S', 'A', 'T'),
+        SPRINT_KEYWORD_ENTRY(STOP, 4, 'S', 'O', 'P'),
+        SPRINT_KEYWORD_ENTRY(STYLE, 5, 'S', 'Y', 'E'),
+        SPRINT_KEYWORD_ENTRY(THERMAL, 7, 'T', 'R', 'L'),
+        SPRINT_KEYWORD_ENTRY(THERMAL_TRACKS, 14, 'T', '_', 'S'),
+        SPRINT_KEYWORD_ENTRY(THERMAL_TRACKS_INDIVIDUAL, 25, 'T', 'K', 'L'),
+        SPRINT_KEYWORD_ENTRY(THERMAL_TRACKS_WIDTH, 20, 'T', 'A', 'H'),
+        SPRINT_KEYWORD_ENTRY(THICKNESS, 9, 'T', 'K', 'S'),
+        SPRINT_KEYWORD_ENTRY(USE_PICKPLACE, 13, 'U', 'C', 'E'),
+        SPRINT_KEYWORD_ENTRY(VIA, 3, 'V', 'I', 'A'),
+        SPRINT_KEYWORD_ENTRY(VISIBLE, 7, 'V', 'I', 'E'),
+        SPRINT_KEYWORD_ENTRY(WIDTH, 5, 'W', 'D', 'H')
+};
+
+bool sprint_keyword_valid(sprint_keyword keyword)
+{
+    return keyword > SPRINT_KEYWORD_UNKNOWN && keyword < sizeof(SPRINT_KEYWORD_NAMES) / sizeof(const char*);
+}
+
+sprint_keyword sprint_keyword_of(const char* span, int length)
+{
+    if (span == NULL || length < 1) return SPRINT_KEYWORD_UNKNOWN;
+
+    // Look up the only keyword that can match, folding letters to upper-case, which leaves underscores intact
+    sprint_keyword keyword = SPRINT_KEYWORD_TABLE[SPRINT_KEYWORD_HASH(length, (unsigned char) span[0] & 0xDF,
+                                                                      (unsigned char) span[length / 2] & 0xDF,
+                                                                      (unsigned char) span[length - 1] & 0xDF)];
+
+    // Verify it, since any other word can have the same hash
+    const char* name = SPRINT_KEYWORD_NAMES[keyword];
+    if (keyword == SPRINT_KEYWORD_UNKNOWN || strncasecmp(span, name, length) != 0 || name[length] != 0)
+        return SPRINT_KEYWORD_UNKNOWN;
+    return keyword;
+}
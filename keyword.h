@@ -0,0 +1,83 @@
+//
+// SprintTrace: keyword recognition
+// Copyright 2022, Laminoid.com (Muessig & Muessig GbR).
+// Licensed under the terms and conditions of the GPLv3.
+//
+
+#ifndef SPRINTTRACE_KEYWORD_H
+#define SPRINTTRACE_KEYWORD_H
+
+#include <stdbool.h>
+
+typedef enum sprint_keyword {
+    SPRINT_KEYWORD_UNKNOWN,
+
+    // Element and text type keywords
+    SPRINT_KEYWORD_TRACK,
+    SPRINT_KEYWORD_PAD,
+    SPRINT_KEYWORD_SMDPAD,
+    SPRINT_KEYWORD_ZONE,
+    SPRINT_KEYWORD_TEXT,
+    SPRINT_KEYWORD_CIRCLE,
+    SPRINT_KEYWORD_BEGIN_COMPONENT,
+    SPRINT_KEYWORD_END_COMPONENT,
+    SPRINT_KEYWORD_GROUP,
+    SPRINT_KEYWORD_END_GROUP,
+    SPRINT_KEYWORD_ID_TEXT,
+    SPRINT_KEYWORD_VALUE_TEXT,
+
+    // Property keywords
+    SPRINT_KEYWORD_CENTER,
+    SPRINT_KEYWORD_CLEAR,
+    SPRINT_KEYWORD_COMMENT,
+    SPRINT_KEYWORD_CON,
+    SPRINT_KEYWORD_CUTOUT,
+    SPRINT_KEYWORD_DRILL,
+    SPRINT_KEYWORD_FILL,
+    SPRINT_KEYWORD_FLATEND,
+    SPRINT_KEYWORD_FLATSTART,
+    SPRINT_KEYWORD_FORM,
+    SPRINT_KEYWORD_HATCH,
+    SPRINT_KEYWORD_HATCH_AUTO,
+    SPRINT_KEYWORD_HATCH_WIDTH,
+    SPRINT_KEYWORD_HEIGHT,
+    SPRINT_KEYWORD_LAYER,
+    SPRINT_KEYWORD_MIRROR_HORZ,
+    SPRINT_KEYWORD_MIRROR_VERT,
+    SPRINT_KEYWORD_NAME,
+    SPRINT_KEYWORD_P,
+    SPRINT_KEYWORD_PACKAGE,
+    SPRINT_KEYWORD_PAD_ID,
+    SPRINT_KEYWORD_POS,
+    SPRINT_KEYWORD_RADIUS,
+    SPRINT_KEYWORD_ROTATION,
+    SPRINT_KEYWORD_SIZE,
+    SPRINT_KEYWORD_SIZE_X,
+    SPRINT_KEYWORD_SIZE_Y,
+    SPRINT_KEYWORD_SOLDERMASK,
+    SPRINT_KEYWORD_SOLDERMASK_CUTOUT,
+    SPRINT_KEYWORD_START,
+    SPRINT_KEYWORD_STOP,
+    SPRINT_KEYWORD_STYLE,
+    SPRINT_KEYWORD_THERMAL,
+    SPRINT_KEYWORD_THERMAL_TRACKS,
+    SPRINT_KEYWORD_THERMAL_TRACKS_INDIVIDUAL,
+    SPRINT_KEYWORD_THERMAL_TRACKS_WIDTH,
+    SPRINT_KEYWORD_THICKNESS,
+    SPRINT_KEYWORD_USE_PICKPLACE,
+    SPRINT_KEYWORD_VIA,
+    SPRINT_KEYWORD_VISIBLE,
+    SPRINT_KEYWORD_WIDTH
+} sprint_keyword;
+extern const char* SPRINT_KEYWORD_NAMES[];
+
+bool sprint_keyword_valid(sprint_keyword keyword);
+/**
+ * Recognizes a keyword in constant time, ignoring the case.
+ * @param span The characters of the word, which do not need to be null-terminated.
+ * @param length The number of characters.
+ * @return The keyword, or unknown if the word is not a keyword.
+ */
+sprint_keyword sprint_keyword_of(const char* span, int length);
+
+#endif //SPRINTTRACE_KEYWORD_H
@@ -5,6 +5,7 @@
 //
 
 #include "list.h"
+#include "arena.h"
 #include "errors.h"
 
 #include <stdlib.h>
@@ -61,6 +62,29 @@ sprint_error sprint_list_complete(sprint_list* list, int* count, void** elements
     return SPRINT_ERROR_NONE;
 }
 
+sprint_error sprint_list_complete_arena(sprint_list* list, sprint_arena* arena, int* count, void** elements)
+{
+    if (list == NULL || arena == NULL || count == NULL || elements == NULL) return SPRINT_ERROR_ARGUMENT_NULL;
+
+    // Copy the elements into the arena, which leaves empty lists without an array like trimming does
+    void* copy = NULL;
+    if (list->count > 0) {
+        copy = sprint_arena_alloc(arena, (size_t) list->size * list->count);
+        if (copy == NULL) {
+            sprint_check(sprint_list_destroy(list));
+            return SPRINT_ERROR_MEMORY;
+        }
+        memcpy(copy, list->elements, (size_t) list->size * list->count);
+    }
+
+    // Store the elements and count
+    *elements = copy;
+    *count = list->count;
+
+    // And finally, destroy the list
+    return sprint_rethrow(sprint_list_destroy(list));
+}
+
 int sprint_list_count(sprint_list* list)
 {
     return list == NULL ? 0 : list->count;
@@ -80,6 +104,18 @@ sprint_error sprint_list_add(sprint_list* list, void* element)
 {
     if (list == NULL || element == NULL) return SPRINT_ERROR_ARGUMENT_NULL;
 
+    // Copy the new element into a new slot at the end of the list
+    void* slot = NULL;
+    sprint_error error = sprint_list_push(list, &slot);
+    if (error != SPRINT_ERROR_NONE) return sprint_rethrow(error);
+    memcpy(slot, element, list->size);
+    return SPRINT_ERROR_NONE;
+}
+
+sprint_error sprint_list_push(sprint_list* list, void** element)
+{
+    if (list == NULL || element == NULL) return SPRINT_ERROR_ARGUMENT_NULL;
+
     // Start with an initial capacity of one
     if (list->capacity < 1) list->capacity = 1;
 
@@ -92,12 +128,32 @@ sprint_error sprint_list_add(sprint_list* list, void* element)
         if (error != SPRINT_ERROR_NONE) return sprint_rethrow(error);
     }
 
-    // Copy the new element to the end of the list and increment the count
-    memcpy(list->elements + list->size * list->count, element, list->size);
+    // Hand out the slot at the end of the list and increment the count
+    *element = list->elements + list->size * list->count;
     list->count++;
     return SPRINT_ERROR_NONE;
 }
 
+sprint_error sprint_list_add_all(sprint_list* list, sprint_list* source)
+{
+    if (list == NULL || source == NULL) return SPRINT_ERROR_ARGUMENT_NULL;
+    if (list->size != source->size) return SPRINT_ERROR_ARGUMENT_RANGE;
+    if (source->count < 1) return SPRINT_ERROR_NONE;
+
+    // Grow the list once, leaving room for one more like adding does
+    int count = list->count + source->count;
+    if (count < list->count) return SPRINT_ERROR_OVERFLOW;
+    if (count >= list->capacity) {
+        sprint_error error = sprint_list_grow(list, count + 1);
+        if (error != SPRINT_ERROR_NONE) return sprint_rethrow(error);
+    }
+
+    // Copy all elements at once
+    memcpy(list->elements + list->size * list->count, source->elements, list->size * source->count);
+    list->count = count;
+    return SPRINT_ERROR_NONE;
+}
+
 void* sprint_list_get(sprint_list* list, int index)
 {
     if (list == NULL || index < 0 || index >= list->count) return NULL;
@@ -7,8 +7,14 @@
 #ifndef SPRINTTRACE_LIST_H
 #define SPRINTTRACE_LIST_H
 
+#include "arena.h"
 #include "errors.h"
 
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
 // Represents a growing list similar to ArrayList in Java
 typedef struct sprint_list {
     // The number of elements in this list
@@ -27,10 +33,28 @@ typedef struct sprint_list {
 sprint_list* sprint_list_create(int width, int capacity);
 sprint_error sprint_list_destroy(sprint_list* list);
 sprint_error sprint_list_complete(sprint_list* list, int* count, void** elements);
+/**
+ * Completes the list like sprint_list_complete, but moves the elements into an arena.
+ * @param list The list to complete, which is destroyed.
+ * @param arena The arena to allocate the elements from.
+ * @param count The target reference to write the number of elements to.
+ * @param elements The target reference to write the elements to, or null if there are none.
+ * @return No error returned on success.
+ */
+sprint_error sprint_list_complete_arena(sprint_list* list, sprint_arena* arena, int* count, void** elements);
 int sprint_list_count(sprint_list* list);
 int sprint_list_size(sprint_list* list);
 int sprint_list_capacity(sprint_list* list);
 sprint_error sprint_list_add(sprint_list* list, void* element);
+/**
+ * Adds an uninitialized element to the end of the list, so that it can be written in place.
+ * @param list The list to add the element to.
+ * @param element The target reference to write the address of the element to.
+ *                It remains valid until the list is grown or destroyed.
+ * @return No error returned on success.
+ */
+sprint_error sprint_list_push(sprint_list* list, void** element);
+sprint_error sprint_list_add_all(sprint_list* list, sprint_list* source);
 void* sprint_list_get(sprint_list* list, int index);
 sprint_error sprint_list_set(sprint_list* list, int index, void* element);
 void* sprint_list_remove(sprint_list* list);
@@ -38,4 +62,100 @@ sprint_error sprint_list_clear(sprint_list* list);
 sprint_error sprint_list_grow(sprint_list* list, int capacity);
 sprint_error sprint_list_trim(sprint_list* list);
 
+/**
+ * Defines a list of a fixed element type, whose operations are inlined with the element size known at compile time.
+ * The list is a plain value, which starts out empty when zero-initialized and holds no memory until it is reserved.
+ * Defines the type sprint_list_<name> and the functions sprint_list_<name>_<operation> with these operations:
+ * reserve(list, capacity) grows the list to hold at least the given number of elements, e.g. from a known count;
+ * push(list, element) adds an uninitialized element and writes its address, which is valid until the list grows;
+ * add(list, element) adds a copy of an element;
+ * get(list, index) returns the address of an element, or null if the index is out of range;
+ * remove(list) removes the last element and returns its address, or null if the list is empty;
+ * complete(list, arena, count, elements) moves the elements into an arena, if there is one, or into a trimmed array,
+ * and empties the list, writing null for no elements;
+ * destroy(list) releases the elements and empties the list.
+ * @param type The type of the elements.
+ * @param name The name of the list type, which is appended to sprint_list_.
+ */
+#define SPRINT_LIST_DEFINE(type, name) \
+typedef struct sprint_list_##name { \
+    int count; \
+    int capacity; \
+    type* elements; \
+} sprint_list_##name; \
+\
+static inline sprint_error sprint_list_##name##_reserve(sprint_list_##name* list, int capacity) \
+{ \
+    if (list == NULL) return SPRINT_ERROR_ARGUMENT_NULL; \
+    if (capacity < 0) return SPRINT_ERROR_ARGUMENT_RANGE; \
+    if (capacity <= list->capacity) return SPRINT_ERROR_NONE; \
+    type* elements = realloc(list->elements, (size_t) capacity * sizeof(type)); \
+    if (elements == NULL) return SPRINT_ERROR_MEMORY; \
+    list->elements = elements; \
+    list->capacity = capacity; \
+    return SPRINT_ERROR_NONE; \
+} \
+\
+static inline sprint_error sprint_list_##name##_push(sprint_list_##name* list, type** element) \
+{ \
+    if (list->count >= list->capacity) { \
+        if (list->capacity > INT_MAX / 2) return SPRINT_ERROR_OVERFLOW; \
+        sprint_error error = sprint_list_##name##_reserve(list, list->capacity > 0 ? list->capacity * 2 : 8); \
+        if (error != SPRINT_ERROR_NONE) return error; \
+    } \
+    *element = &list->elements[list->count++]; \
+    return SPRINT_ERROR_NONE; \
+} \
+\
+static inline sprint_error sprint_list_##name##_add(sprint_list_##name* list, type element) \
+{ \
+    type* slot = NULL; \
+    sprint_error error = sprint_list_##name##_push(list, &slot); \
+    if (error == SPRINT_ERROR_NONE) \
+        *slot = element; \
+    return error; \
+} \
+\
+static inline type* sprint_list_##name##_get(sprint_list_##name* list, int index) \
+{ \
+    return index >= 0 && index < list->count ? &list->elements[index] : NULL; \
+} \
+\
+static inline type* sprint_list_##name##_remove(sprint_list_##name* list) \
+{ \
+    return list->count > 0 ? &list->elements[--list->count] : NULL; \
+} \
+\
+static inline void sprint_list_##name##_destroy(sprint_list_##name* list) \
+{ \
+    free(list->elements); \
+    list->elements = NULL; \
+    list->count = 0; \
+    list->capacity = 0; \
+} \
+\
+static inline sprint_error sprint_list_##name##_complete(sprint_list_##name* list, sprint_arena* arena, int* count, \
+                                                         type** elements) \
+{ \
+    if (list == NULL || count == NULL || elements == NULL) return SPRINT_ERROR_ARGUMENT_NULL; \
+    type* completed = NULL; \
+    if (list->count > 0 && arena != NULL) { \
+        completed = sprint_arena_alloc(arena, (size_t) list->count * sizeof(type)); \
+        if (completed != NULL) \
+            memcpy(completed, list->elements, (size_t) list->count * sizeof(type)); \
+    } else if (list->count > 0) { \
+        completed = list->count < list->capacity ? \
+                realloc(list->elements, (size_t) list->count * sizeof(type)) : list->elements; \
+        if (completed != NULL) \
+            list->elements = NULL; \
+    } \
+    bool success = list->count < 1 || completed != NULL; \
+    if (success) { \
+        *count = list->count; \
+        *elements = completed; \
+    } \
+    sprint_list_##name##_destroy(list); \
+    return success ? SPRINT_ERROR_NONE : SPRINT_ERROR_MEMORY; \
+}
+
 #endif //SPRINTTRACE_LIST_H
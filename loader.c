@@ -0,0 +1,775 @@
+//
+// SprintTrace: parallel element loader
+// Copyright 2022, Laminoid.com (Muessig & Muessig GbR).
+// Licensed under the terms and conditions of the GPLv3.
+//
+
+#include "loader.h"
+#include "parser.h"
+#include "pcb.h"
+#include "elements.h"
+#include "list.h"
+#include "storage.h"
+#include "arena.h"
+#include "token.h"
+#include "keyword.h"
+#include "errors.h"
+
+#include <limits.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+const int SPRINT_LOADER_CHUNK_SIZE = 1024 * 1024;
+const int SPRINT_LOADER_THREADS_MAX = 64;
+
+typedef struct sprint_loader_chunk {
+    // The tokenizer of the entire source
+    sprint_tokenizer* source;
+
+    // The range of the chunk inside the source
+    int start;
+    int end;
+
+    // The parsed elements
+    sprint_storage elements;
+
+    // The arena to allocate the elements from, or null to allocate them individually
+    sprint_arena* arena;
+
+    // Whether any of the elements needed to be salvaged
+    bool salvaged;
+
+    // The status of parsing the chunk
+    sprint_error error;
+} sprint_loader_chunk;
+
+typedef struct sprint_loader_splitter {
+    // The number of chunks to split into, and the number of chunks found so far
+    int count;
+    int chunks;
+
+    // The length of the source and the start offsets of the chunks
+    int length;
+    int* starts;
+} sprint_loader_splitter;
+
+typedef struct sprint_loader_indexer {
+    // The source to check the elements in, and the list of entries to add to
+    const char* source;
+    sprint_list* entries;
+
+    // The status of indexing
+    sprint_error error;
+} sprint_loader_indexer;
+
+// The kinds of property values, which are checked exactly like the element parsers decode them
+typedef enum sprint_loader_value {
+    SPRINT_LOADER_VALUE_NONE,
+    SPRINT_LOADER_VALUE_INT,
+    SPRINT_LOADER_VALUE_UINT,
+    SPRINT_LOADER_VALUE_SIZE,
+    SPRINT_LOADER_VALUE_LAYER,
+    SPRINT_LOADER_VALUE_BOOL,
+    SPRINT_LOADER_VALUE_STR,
+    SPRINT_LOADER_VALUE_TUPLE,
+    SPRINT_LOADER_VALUE_ANGLE_COARSE,
+    SPRINT_LOADER_VALUE_ANGLE_WHOLE,
+    SPRINT_LOADER_VALUE_ANGLE_FINE,
+    SPRINT_LOADER_VALUE_THT_FORM,
+    SPRINT_LOADER_VALUE_TEXT_STYLE,
+    SPRINT_LOADER_VALUE_TEXT_THICKNESS,
+    SPRINT_LOADER_VALUE_THERMAL_TRACKS,
+    SPRINT_LOADER_VALUE_THERMAL_TRACKS_WIDTH
+} sprint_loader_value;
+
+// The properties of every element type and the kinds of their values, which mirror the element parsers
+static const sprint_loader_value SPRINT_LOADER_VALUES[][SPRINT_KEYWORD_WIDTH + 1] = {
+        [SPRINT_ELEMENT_TRACK] = {
+                [SPRINT_KEYWORD_P] = SPRINT_LOADER_VALUE_TUPLE,
+                [SPRINT_KEYWORD_LAYER] = SPRINT_LOADER_VALUE_LAYER,
+                [SPRINT_KEYWORD_WIDTH] = SPRINT_LOADER_VALUE_SIZE,
+                [SPRINT_KEYWORD_CLEAR] = SPRINT_LOADER_VALUE_SIZE,
+                [SPRINT_KEYWORD_CUTOUT] = SPRINT_LOADER_VALUE_BOOL,
+                [SPRINT_KEYWORD_SOLDERMASK] = SPRINT_LOADER_VALUE_BOOL,
+                [SPRINT_KEYWORD_FLATSTART] = SPRINT_LOADER_VALUE_BOOL,
+                [SPRINT_KEYWORD_FLATEND] = SPRINT_LOADER_VALUE_BOOL,
+                [SPRINT_KEYWORD_NAME] = SPRINT_LOADER_VALUE_STR
+        },
+        [SPRINT_ELEMENT_PAD_THT] = {
+                [SPRINT_KEYWORD_CON] = SPRINT_LOADER_VALUE_UINT,
+                [SPRINT_KEYWORD_LAYER] = SPRINT_LOADER_VALUE_LAYER,
+                [SPRINT_KEYWORD_POS] = SPRINT_LOADER_VALUE_TUPLE,
+                [SPRINT_KEYWORD_SIZE] = SPRINT_LOADER_VALUE_SIZE,
+                [SPRINT_KEYWORD_DRILL] = SPRINT_LOADER_VALUE_SIZE,
+                [SPRINT_KEYWORD_FORM] = SPRINT_LOADER_VALUE_THT_FORM,
+                [SPRINT_KEYWORD_PAD_ID] = SPRINT_LOADER_VALUE_UINT,
+                [SPRINT_KEYWORD_CLEAR] = SPRINT_LOADER_VALUE_SIZE,
+                [SPRINT_KEYWORD_SOLDERMASK] = SPRINT_LOADER_VALUE_BOOL,
+                [SPRINT_KEYWORD_ROTATION] = SPRINT_LOADER_VALUE_ANGLE_COARSE,
+                [SPRINT_KEYWORD_VIA] = SPRINT_LOADER_VALUE_BOOL,
+                [SPRINT_KEYWORD_THERMAL] = SPRINT_LOADER_VALUE_BOOL,
+                [SPRINT_KEYWORD_THERMAL_TRACKS] = SPRINT_LOADER_VALUE_INT,
+                [SPRINT_KEYWORD_THERMAL_TRACKS_WIDTH] = SPRINT_LOADER_VALUE_THERMAL_TRACKS_WIDTH,
+                [SPRINT_KEYWORD_THERMAL_TRACKS_INDIVIDUAL] = SPRINT_LOADER_VALUE_BOOL,
+                [SPRINT_KEYWORD_NAME] = SPRINT_LOADER_VALUE_STR
+        },
+        [SPRINT_ELEMENT_PAD_SMT] = {
+                [SPRINT_KEYWORD_CON] = SPRINT_LOADER_VALUE_UINT,
+                [SPRINT_KEYWORD_LAYER] = SPRINT_LOADER_VALUE_LAYER,
+                [SPRINT_KEYWORD_POS] = SPRINT_LOADER_VALUE_TUPLE,
+                [SPRINT_KEYWORD_SIZE_X] = SPRINT_LOADER_VALUE_SIZE,
+                [SPRINT_KEYWORD_SIZE_Y] = SPRINT_LOADER_VALUE_SIZE,
+                [SPRINT_KEYWORD_PAD_ID] = SPRINT_LOADER_VALUE_UINT,
+                [SPRINT_KEYWORD_CLEAR] = SPRINT_LOADER_VALUE_SIZE,
+                [SPRINT_KEYWORD_SOLDERMASK] = SPRINT_LOADER_VALUE_BOOL,
+                [SPRINT_KEYWORD_ROTATION] = SPRINT_LOADER_VALUE_ANGLE_COARSE,
+                [SPRINT_KEYWORD_THERMAL] = SPRINT_LOADER_VALUE_BOOL,
+                [SPRINT_KEYWORD_THERMAL_TRACKS] = SPRINT_LOADER_VALUE_THERMAL_TRACKS,
+                [SPRINT_KEYWORD_THERMAL_TRACKS_WIDTH] = SPRINT_LOADER_VALUE_THERMAL_TRACKS_WIDTH,
+                [SPRINT_KEYWORD_NAME] = SPRINT_LOADER_VALUE_STR
+        },
+        [SPRINT_ELEMENT_ZONE] = {
+                [SPRINT_KEYWORD_P] = SPRINT_LOADER_VALUE_TUPLE,
+                [SPRINT_KEYWORD_LAYER] = SPRINT_LOADER_VALUE_LAYER,
+                [SPRINT_KEYWORD_WIDTH] = SPRINT_LOADER_VALUE_SIZE,
+                [SPRINT_KEYWORD_CLEAR] = SPRINT_LOADER_VALUE_SIZE,
+                [SPRINT_KEYWORD_CUTOUT] = SPRINT_LOADER_VALUE_BOOL,
+                [SPRINT_KEYWORD_SOLDERMASK] = SPRINT_LOADER_VALUE_BOOL,
+                [SPRINT_KEYWORD_SOLDERMASK_CUTOUT] = SPRINT_LOADER_VALUE_BOOL,
+                [SPRINT_KEYWORD_HATCH] = SPRINT_LOADER_VALUE_BOOL,
+                [SPRINT_KEYWORD_HATCH_AUTO] = SPRINT_LOADER_VALUE_BOOL,
+                [SPRINT_KEYWORD_HATCH_WIDTH] = SPRINT_LOADER_VALUE_SIZE,
+                [SPRINT_KEYWORD_NAME] = SPRINT_LOADER_VALUE_STR
+        },
+        [SPRINT_ELEMENT_TEXT] = {
+                [SPRINT_KEYWORD_LAYER] = SPRINT_LOADER_VALUE_LAYER,
+                [SPRINT_KEYWORD_POS] = SPRINT_LOADER_VALUE_TUPLE,
+                [SPRINT_KEYWORD_HEIGHT] = SPRINT_LOADER_VALUE_SIZE,
+                [SPRINT_KEYWORD_TEXT] = SPRINT_LOADER_VALUE_STR,
+                [SPRINT_KEYWORD_CLEAR] = SPRINT_LOADER_VALUE_SIZE,
+                [SPRINT_KEYWORD_CUTOUT] = SPRINT_LOADER_VALUE_BOOL,
+                [SPRINT_KEYWORD_SOLDERMASK] = SPRINT_LOADER_VALUE_BOOL,
+                [SPRINT_KEYWORD_STYLE] = SPRINT_LOADER_VALUE_TEXT_STYLE,
+                [SPRINT_KEYWORD_THICKNESS] = SPRINT_LOADER_VALUE_TEXT_THICKNESS,
+                [SPRINT_KEYWORD_FLATEND] = SPRINT_LOADER_VALUE_ANGLE_WHOLE,
+                [SPRINT_KEYWORD_MIRROR_HORZ] = SPRINT_LOADER_VALUE_BOOL,
+                [SPRINT_KEYWORD_MIRROR_VERT] = SPRINT_LOADER_VALUE_BOOL,
+                [SPRINT_KEYWORD_NAME] = SPRINT_LOADER_VALUE_STR,
+                [SPRINT_KEYWORD_VISIBLE] = SPRINT_LOADER_VALUE_BOOL
+        },
+        [SPRINT_ELEMENT_CIRCLE] = {
+                [SPRINT_KEYWORD_LAYER] = SPRINT_LOADER_VALUE_LAYER,
+                [SPRINT_KEYWORD_WIDTH] = SPRINT_LOADER_VALUE_SIZE,
+                [SPRINT_KEYWORD_CENTER] = SPRINT_LOADER_VALUE_TUPLE,
+                [SPRINT_KEYWORD_RADIUS] = SPRINT_LOADER_VALUE_SIZE,
+                [SPRINT_KEYWORD_CLEAR] = SPRINT_LOADER_VALUE_SIZE,
+                [SPRINT_KEYWORD_CUTOUT] = SPRINT_LOADER_VALUE_BOOL,
+                [SPRINT_KEYWORD_SOLDERMASK] = SPRINT_LOADER_VALUE_BOOL,
+                [SPRINT_KEYWORD_START] = SPRINT_LOADER_VALUE_ANGLE_FINE,
+                [SPRINT_KEYWORD_STOP] = SPRINT_LOADER_VALUE_ANGLE_FINE,
+                [SPRINT_KEYWORD_FILL] = SPRINT_LOADER_VALUE_BOOL,
+                [SPRINT_KEYWORD_NAME] = SPRINT_LOADER_VALUE_STR
+        },
+        [SPRINT_ELEMENT_COMPONENT] = {
+                [SPRINT_KEYWORD_COMMENT] = SPRINT_LOADER_VALUE_STR,
+                [SPRINT_KEYWORD_USE_PICKPLACE] = SPRINT_LOADER_VALUE_BOOL,
+                [SPRINT_KEYWORD_PACKAGE] = SPRINT_LOADER_VALUE_STR,
+                [SPRINT_KEYWORD_ROTATION] = SPRINT_LOADER_VALUE_ANGLE_WHOLE
+        },
+        [SPRINT_ELEMENT_GROUP] = {0}
+};
+
+// Called for every top-level element with its range, keyword and whether its source consists of plain lines only,
+// that is without comments or carriage returns, returns whether to continue scanning
+typedef bool (*sprint_loader_boundary)(void* user, int start, int end, sprint_keyword keyword, bool plain);
+
+static sprint_error sprint_loader_parse_sequential_internal(sprint_tokenizer* tokenizer, sprint_storage* elements,
+                                                            sprint_arena* arena, bool* salvaged);
+static bool sprint_loader_scan_internal(const char* source, int length, sprint_loader_boundary boundary, void* user);
+static bool sprint_loader_split_boundary_internal(void* user, __attribute__((unused)) int start, int end,
+                                                  __attribute__((unused)) sprint_keyword keyword,
+                                                  __attribute__((unused)) bool plain);
+static bool sprint_loader_index_boundary_internal(void* user, int start, int end, sprint_keyword keyword, bool plain);
+static int sprint_loader_split_internal(const char* source, int length, int count, int* starts);
+static bool sprint_loader_check_internal(const char* source, int* offset, int end, sprint_element_type parent,
+                                         int depth, sprint_text_type* subtype);
+static bool sprint_loader_value_internal(const char* source, int* offset, int end, sprint_loader_value value,
+                                         bool* flag);
+static sprint_keyword sprint_loader_word_internal(const char* source, int* offset, int end);
+static bool sprint_loader_int_internal(const char* source, int* offset, int end, int* val);
+static void sprint_loader_run_internal(sprint_loader_chunk* chunk);
+static void sprint_loader_discard_internal(sprint_loader_chunk* chunk);
+
+int sprint_loader_threads(void)
+{
+#ifdef WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    long count = (long) info.dwNumberOfProcessors;
+#else
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+
+    // Fall back to a single thread, if the count is unknown
+    if (count < 1)
+        return 1;
+    return count > SPRINT_LOADER_THREADS_MAX ? SPRINT_LOADER_THREADS_MAX : (int) count;
+}
+
+#ifdef WIN32
+static DWORD WINAPI sprint_loader_thread_internal(LPVOID chunk)
+{
+    sprint_loader_run_internal(chunk);
+    return 0;
+}
+#else
+static void* sprint_loader_thread_internal(void* chunk)
+{
+    sprint_loader_run_internal(chunk);
+    return NULL;
+}
+#endif
+
+sprint_error sprint_loader_parse(sprint_tokenizer* tokenizer, int threads, sprint_storage* elements,
+                                 sprint_arena* arena, bool* salvaged)
+{
+    if (tokenizer == NULL || elements == NULL || salvaged == NULL) return SPRINT_ERROR_ARGUMENT_NULL;
+    if (threads < 0) return SPRINT_ERROR_ARGUMENT_RANGE;
+    if (tokenizer->preloaded) return SPRINT_ERROR_STATE_INVALID;
+
+    // Only sources that are addressable in their entirety can be split, and only if they are big enough
+    if (threads == 0)
+        threads = sprint_loader_threads();
+    int length = tokenizer->persistent && tokenizer->block != NULL ?
+            (int) (tokenizer->block_end - tokenizer->block) : 0;
+    if (threads > length / SPRINT_LOADER_CHUNK_SIZE)
+        threads = length / SPRINT_LOADER_CHUNK_SIZE;
+    if (threads > SPRINT_LOADER_THREADS_MAX)
+        threads = SPRINT_LOADER_THREADS_MAX;
+    if (threads < 2)
+        return sprint_rethrow(sprint_loader_parse_sequential_internal(tokenizer, elements, arena, salvaged));
+
+    // Split the source at top-level element boundaries
+    int starts[threads];
+    int count = sprint_loader_split_internal(tokenizer->block, length, threads, starts);
+    if (count < 2)
+        return sprint_rethrow(sprint_loader_parse_sequential_internal(tokenizer, elements, arena, salvaged));
+
+    // Prepare the chunks, which get arenas of their own to allocate from concurrently
+    sprint_loader_chunk chunks[count];
+    memset(chunks, 0, sizeof(chunks));
+    for (int index = 0; index < count; index++) {
+        chunks[index].source = tokenizer;
+        chunks[index].start = starts[index];
+        chunks[index].end = index + 1 < count ? starts[index + 1] : length;
+        if (arena != NULL && (chunks[index].arena = sprint_arena_create(arena->huge)) == NULL) {
+            for (int created = 0; created < index; created++)
+                sprint_check(sprint_arena_destroy(chunks[created].arena));
+            return sprint_rethrow(sprint_loader_parse_sequential_internal(tokenizer, elements, arena, salvaged));
+        }
+    }
+
+    // Parse all chunks but the first one on their own threads, falling back to this one if they cannot be started
+#ifdef WIN32
+    HANDLE handles[count];
+#else
+    pthread_t handles[count];
+#endif
+    bool started[count];
+    for (int index = 1; index < count; index++) {
+#ifdef WIN32
+        handles[index] = CreateThread(NULL, 0, sprint_loader_thread_internal, &chunks[index], 0, NULL);
+        started[index] = handles[index] != NULL;
+#else
+        started[index] = pthread_create(&handles[index], NULL, sprint_loader_thread_internal, &chunks[index]) == 0;
+#endif
+        if (!started[index])
+            sprint_loader_run_internal(&chunks[index]);
+    }
+    sprint_loader_run_internal(&chunks[0]);
+
+    // Wait for the threads to complete
+    for (int index = 1; index < count; index++) {
+        if (!started[index])
+            continue;
+#ifdef WIN32
+        WaitForSingleObject(handles[index], INFINITE);
+        CloseHandle(handles[index]);
+#else
+        pthread_join(handles[index], NULL);
+#endif
+    }
+
+    // Make sure that all chunks were parsed without any issues
+    bool clean = true;
+    for (int index = 0; index < count; index++)
+        clean &= chunks[index].error == SPRINT_ERROR_NONE && !chunks[index].salvaged;
+
+    // If not, discard the results and parse sequentially, which reproduces the exact diagnostics
+    if (!clean) {
+        for (int index = 0; index < count; index++)
+            sprint_loader_discard_internal(&chunks[index]);
+        return sprint_rethrow(sprint_loader_parse_sequential_internal(tokenizer, elements, arena, salvaged));
+    }
+
+    // Otherwise, add the elements in the order of the source
+    sprint_error error = SPRINT_ERROR_NONE;
+    for (int index = 0; index < count; index++) {
+        sprint_loader_chunk* chunk = &chunks[index];
+        bool added = error == SPRINT_ERROR_NONE && sprint_chain(error, sprint_storage_append(elements, &chunk->elements));
+        if (added) {
+            // The storage holds the elements now, so only release the blocks of the chunk
+            sprint_check(sprint_storage_destroy(&chunk->elements));
+        }
+
+        // Keep the memory of the elements, which is now referenced by the storage
+        if (added && chunk->arena != NULL) {
+            sprint_check(sprint_arena_merge(arena, chunk->arena));
+            chunk->arena = NULL;
+        }
+        sprint_loader_discard_internal(chunk);
+    }
+
+    // The last element of a clean input has never been salvaged
+    *salvaged = false;
+    return sprint_rethrow(error);
+}
+
+sprint_error sprint_loader_index(sprint_tokenizer* tokenizer, sprint_list* entries)
+{
+    if (tokenizer == NULL || entries == NULL) return SPRINT_ERROR_ARGUMENT_NULL;
+    if (!tokenizer->persistent || tokenizer->block == NULL) return SPRINT_ERROR_STATE_INVALID;
+
+    // Follow the entire source, which fails if it cannot be split into top-level elements reliably
+    sprint_loader_indexer indexer = {.source = tokenizer->block, .entries = entries};
+    int length = (int) (tokenizer->block_end - tokenizer->block);
+    if (!sprint_loader_scan_internal(tokenizer->block, length, sprint_loader_index_boundary_internal, &indexer) &&
+        indexer.error == SPRINT_ERROR_NONE)
+        indexer.error = SPRINT_ERROR_SYNTAX;
+    return indexer.error;
+}
+
+sprint_error sprint_loader_parse_sequential_internal(sprint_tokenizer* tokenizer, sprint_storage* elements,
+                                                     sprint_arena* arena, bool* salvaged)
+{
+    // Create the parser
+    sprint_parser* parser = sprint_parser_create(tokenizer);
+    if (parser == NULL)
+        return SPRINT_ERROR_MEMORY;
+    sprint_check(sprint_parser_arena(parser, arena));
+
+    // Parse all elements
+    sprint_error error = SPRINT_ERROR_NONE;
+    sprint_element* element;
+    while (true) {
+        // Read the element directly into a new slot at the end of the storage
+        if (!sprint_chain(error, sprint_storage_push(elements, &element)))
+            break;
+        error = sprint_parser_next_element_into(parser, element, salvaged);
+        if (error != SPRINT_ERROR_NONE)
+            sprint_storage_remove(elements);
+
+        // Handle EOF
+        if (error == SPRINT_ERROR_EOF) {
+            error = SPRINT_ERROR_NONE;
+            break;
+        }
+
+        // Handle other errors
+        if (!sprint_check(error))
+            break;
+    }
+
+    // Destroy the parser, but keep the tokenizer
+    sprint_check(sprint_parser_destroy(parser, false, NULL));
+    return sprint_rethrow(error);
+}
+
+bool sprint_loader_scan_internal(const char* source, int length, sprint_loader_boundary boundary, void* user)
+{
+    // Follow the statements to find the boundaries between top-level elements
+    int depth = 0, start = -1;
+    sprint_keyword keyword = SPRINT_KEYWORD_UNKNOWN;
+    bool first = true, plain = true;
+    for (int offset = 0; offset < length;) {
+        switch (source[offset]) {
+            case '#':
+                // Skip the comment up to the end of the line
+                plain &= start < 0;
+                while (offset < length && source[offset] != '\n' && source[offset] != '\r')
+                    offset++;
+                break;
+
+            case '|':
+                // Strings cannot start a statement
+                if (first)
+                    return false;
+
+                // Skip the string, which ends at a delimiter or the end of the line
+                offset++;
+                while (offset < length && source[offset] != '|' && source[offset] != '\n' && source[offset] != '\r')
+                    offset++;
+                offset++;
+                break;
+
+            case ';':
+                // Report the top-level element after its terminator
+                offset++;
+                first = true;
+                if (depth == 0 && start >= 0) {
+                    if (!boundary(user, start, offset, keyword, plain))
+                        return false;
+                    start = -1;
+                }
+                break;
+
+            case '\r':
+                plain &= start < 0;
+                offset++;
+                break;
+
+            case ' ':
+            case '\t':
+            case '\n':
+                offset++;
+                break;
+
+            default:
+                if (!first) {
+                    offset++;
+                    break;
+                }
+
+                // The statement must start with a keyword, that is followed by a separator or terminator
+                int name = offset;
+                while (offset < length && ((source[offset] >= 'A' && source[offset] <= 'Z') ||
+                                           (source[offset] >= 'a' && source[offset] <= 'z') || source[offset] == '_'))
+                    offset++;
+                if (offset == name || offset >= length || (source[offset] != ',' && source[offset] != ';'))
+                    return false;
+                first = false;
+
+                // Remember where a top-level element starts and by which keyword
+                sprint_keyword statement = sprint_keyword_of(source + name, offset - name);
+                if (depth == 0) {
+                    start = name;
+                    keyword = statement;
+                    plain = true;
+                }
+
+                // Follow the nesting of components and groups, whose closing keywords must stand alone
+                if (statement == SPRINT_KEYWORD_BEGIN_COMPONENT || statement == SPRINT_KEYWORD_GROUP)
+                    depth++;
+                else if (statement == SPRINT_KEYWORD_END_COMPONENT || statement == SPRINT_KEYWORD_END_GROUP) {
+                    if (depth < 1 || source[offset] != ';')
+                        return false;
+                    depth--;
+                }
+                break;
+        }
+    }
+
+    // Unbalanced nesting or a missing terminator ends inside an element, which cannot be split safely
+    return depth == 0 && first;
+}
+
+bool sprint_loader_split_boundary_internal(void* user, __attribute__((unused)) int start, int end,
+                                           __attribute__((unused)) sprint_keyword keyword,
+                                           __attribute__((unused)) bool plain)
+{
+    // Split after a top-level element, once the next target is reached
+    sprint_loader_splitter* split = user;
+    if (split->chunks < split->count && end >= (int) ((long long) split->length * split->chunks / split->count))
+        split->starts[split->chunks++] = end;
+    return true;
+}
+
+bool sprint_loader_index_boundary_internal(void* user, int start, int end, sprint_keyword keyword, bool plain)
+{
+    // Only opening keywords of elements can start a top-level element
+    sprint_loader_indexer* indexer = user;
+    sprint_element_type type;
+    bool closing = false;
+    if (!sprint_element_type_from_keyword_id(&type, &closing, keyword) || closing)
+        return false;
+
+    // Check whether the source of plain elements parses cleanly, which is all that writing them out as is requires
+    int offset = start;
+    bool checked = plain && sprint_loader_check_internal(indexer->source, &offset, end, type, 0, NULL) &&
+            offset == end;
+
+    // Add the entry, which is only decoded later
+    sprint_pcb_entry entry = {.type = type, .start = start, .end = end, .plain = plain, .checked = checked};
+    return sprint_chain(indexer->error, sprint_list_add(indexer->entries, &entry));
+}
+
+int sprint_loader_split_internal(const char* source, int length, int count, int* starts)
+{
+    // The first chunk always starts at the beginning
+    starts[0] = 0;
+    sprint_loader_splitter split = {.count = count, .chunks = 1, .length = length, .starts = starts};
+
+    // Find the boundaries between top-level elements near the targets
+    return sprint_loader_scan_internal(source, length, sprint_loader_split_boundary_internal, &split) ?
+            split.chunks : 1;
+}
+
+bool sprint_loader_check_internal(const char* source, int* offset, int end, sprint_element_type parent, int depth,
+                                  sprint_text_type* subtype)
+{
+    // Only accept what the parser reads without salvaging or overwriting anything, in the form that Sprint-Layout
+    // writes it, so that anything else is left to be decided by actually parsing it
+    if (depth >= SPRINT_ELEMENT_DEPTH)
+        return false;
+
+    // Determine the type of the element, while texts of components can also be their ID or value
+    sprint_keyword keyword = sprint_loader_word_internal(source, offset, end);
+    sprint_element_type type;
+    sprint_text_type text_type = SPRINT_TEXT_REGULAR;
+    bool closing = false;
+    if (depth > 0 && parent == SPRINT_ELEMENT_COMPONENT && sprint_text_type_from_keyword_id(&text_type, keyword))
+        type = SPRINT_ELEMENT_TEXT;
+    else if (!sprint_element_type_from_keyword_id(&type, &closing, keyword) || closing)
+        return false;
+    if (subtype != NULL)
+        *subtype = text_type;
+
+    // Check the properties, which must be known to the type, and whose indices must count up from zero
+    bool found[SPRINT_KEYWORD_WIDTH + 1] = {false}, flags[SPRINT_KEYWORD_WIDTH + 1] = {false};
+    sprint_keyword indexed = type == SPRINT_ELEMENT_TRACK || type == SPRINT_ELEMENT_ZONE ? SPRINT_KEYWORD_P :
+            type == SPRINT_ELEMENT_PAD_THT || type == SPRINT_ELEMENT_PAD_SMT ? SPRINT_KEYWORD_CON : SPRINT_KEYWORD_UNKNOWN;
+    int count = 0;
+    while (*offset < end && source[*offset] == ',') {
+        (*offset)++;
+        sprint_keyword property = sprint_loader_word_internal(source, offset, end);
+        int index = -1;
+        if (*offset < end && source[*offset] >= '0' && source[*offset] <= '9' &&
+            !sprint_loader_int_internal(source, offset, end, &index))
+            return false;
+        if ((index < 0) == (property == indexed) || (index >= 0 && index != count++))
+            return false;
+        if (*offset >= end || source[*offset] != '=')
+            return false;
+        (*offset)++;
+        sprint_loader_value value = SPRINT_LOADER_VALUES[type][property];
+        if (value == SPRINT_LOADER_VALUE_NONE || (index < 0 && found[property]) ||
+            !sprint_loader_value_internal(source, offset, end, value, &flags[property]))
+            return false;
+        found[property] = true;
+    }
+    if (*offset >= end || source[*offset] != ';')
+        return false;
+    (*offset)++;
+
+    // Make sure that there are all properties, like the parser does
+    bool complete;
+    switch (type) {
+        case SPRINT_ELEMENT_TRACK:
+            complete = found[SPRINT_KEYWORD_LAYER] && found[SPRINT_KEYWORD_WIDTH] && count >= 2;
+            break;
+        case SPRINT_ELEMENT_PAD_THT:
+            complete = found[SPRINT_KEYWORD_LAYER] && found[SPRINT_KEYWORD_POS] && found[SPRINT_KEYWORD_SIZE] &&
+                    found[SPRINT_KEYWORD_DRILL] && found[SPRINT_KEYWORD_FORM] &&
+                    (!flags[SPRINT_KEYWORD_THERMAL] || (found[SPRINT_KEYWORD_THERMAL_TRACKS] &&
+                    found[SPRINT_KEYWORD_THERMAL_TRACKS_WIDTH] && found[SPRINT_KEYWORD_THERMAL_TRACKS_INDIVIDUAL]));
+            break;
+        case SPRINT_ELEMENT_PAD_SMT:
+            complete = found[SPRINT_KEYWORD_LAYER] && found[SPRINT_KEYWORD_POS] && found[SPRINT_KEYWORD_SIZE_X] &&
+                    found[SPRINT_KEYWORD_SIZE_Y] && (!flags[SPRINT_KEYWORD_THERMAL] ||
+                    (found[SPRINT_KEYWORD_THERMAL_TRACKS] && found[SPRINT_KEYWORD_THERMAL_TRACKS_WIDTH]));
+            break;
+        case SPRINT_ELEMENT_ZONE:
+            // Hatching is automatic by default, and zones cannot be cutouts of both kinds
+            complete = found[SPRINT_KEYWORD_LAYER] && found[SPRINT_KEYWORD_WIDTH] && count >= 2 &&
+                    (!flags[SPRINT_KEYWORD_HATCH] || !found[SPRINT_KEYWORD_HATCH_AUTO] ||
+                    flags[SPRINT_KEYWORD_HATCH_AUTO] || found[SPRINT_KEYWORD_HATCH_WIDTH]) &&
+                    !(flags[SPRINT_KEYWORD_CUTOUT] && flags[SPRINT_KEYWORD_SOLDERMASK_CUTOUT]);
+            break;
+        case SPRINT_ELEMENT_TEXT:
+            complete = found[SPRINT_KEYWORD_LAYER] && found[SPRINT_KEYWORD_POS] && found[SPRINT_KEYWORD_HEIGHT] &&
+                    found[SPRINT_KEYWORD_TEXT];
+            break;
+        case SPRINT_ELEMENT_CIRCLE:
+            complete = found[SPRINT_KEYWORD_LAYER] && found[SPRINT_KEYWORD_WIDTH] && found[SPRINT_KEYWORD_CENTER] &&
+                    found[SPRINT_KEYWORD_RADIUS];
+            break;
+        default:
+            complete = true;
+            break;
+    }
+    if (!complete || (type != SPRINT_ELEMENT_COMPONENT && type != SPRINT_ELEMENT_GROUP))
+        return complete;
+
+    // Check the elements of components and groups up to their closing keyword, which must stand alone
+    bool found_text_id = false, found_text_value = false;
+    while (true) {
+        while (*offset < end && (source[*offset] == ' ' || source[*offset] == '\t' || source[*offset] == '\n'))
+            (*offset)++;
+        int next = *offset;
+        sprint_element_type closed;
+        if (sprint_element_type_from_keyword_id(&closed, &closing, sprint_loader_word_internal(source, &next, end)) &&
+            closing) {
+            if (closed != type || next >= end || source[next] != ';')
+                return false;
+            *offset = next + 1;
+            break;
+        }
+        sprint_text_type child_type;
+        if (!sprint_loader_check_internal(source, offset, end, type, depth + 1, &child_type) ||
+            (child_type == SPRINT_TEXT_ID && found_text_id) || (child_type == SPRINT_TEXT_VALUE && found_text_value))
+            return false;
+        found_text_id |= child_type == SPRINT_TEXT_ID;
+        found_text_value |= child_type == SPRINT_TEXT_VALUE;
+    }
+    return type != SPRINT_ELEMENT_COMPONENT || (found_text_id && found_text_value);
+}
+
+bool sprint_loader_value_internal(const char* source, int* offset, int end, sprint_loader_value value, bool* flag)
+{
+    int start = *offset, number = 0;
+    switch (value) {
+        case SPRINT_LOADER_VALUE_BOOL:
+            sprint_loader_word_internal(source, offset, end);
+            return sprint_span_bool(source + start, *offset - start, flag) == SPRINT_ERROR_NONE;
+
+        case SPRINT_LOADER_VALUE_STR:
+            // Strings must be terminated on the same line
+            if (*offset >= end || source[*offset] != '|')
+                return false;
+            for ((*offset)++; *offset < end && source[*offset] != '|'; (*offset)++)
+                if (source[*offset] == '\n' || source[*offset] == '\r')
+                    return false;
+            return (*offset)++ < end;
+
+        case SPRINT_LOADER_VALUE_TUPLE:
+            if (!sprint_loader_int_internal(source, offset, end, &number) || !sprint_dist_valid(number) ||
+                *offset >= end || source[*offset] != '/')
+                return false;
+            (*offset)++;
+            return sprint_loader_int_internal(source, offset, end, &number) && sprint_dist_valid(number);
+
+        default:
+            break;
+    }
+
+    // All other values are numbers, whose ranges depend on the kind of value, while angles are scaled without overflowing
+    if (!sprint_loader_int_internal(source, offset, end, &number))
+        return false;
+    sprint_prim_format format = value == SPRINT_LOADER_VALUE_ANGLE_COARSE ? SPRINT_PRIM_FORMAT_ANGLE_COARSE :
+            value == SPRINT_LOADER_VALUE_ANGLE_WHOLE ? SPRINT_PRIM_FORMAT_ANGLE_WHOLE : SPRINT_PRIM_FORMAT_ANGLE_FINE;
+    long long angle = (long long) number * sprint_angle_factor(format);
+    switch (value) {
+        case SPRINT_LOADER_VALUE_INT:
+            return true;
+        case SPRINT_LOADER_VALUE_UINT:
+            return number >= 0;
+        case SPRINT_LOADER_VALUE_SIZE:
+            return sprint_size_valid(number);
+        case SPRINT_LOADER_VALUE_LAYER:
+            return sprint_layer_valid(number);
+        case SPRINT_LOADER_VALUE_ANGLE_COARSE:
+        case SPRINT_LOADER_VALUE_ANGLE_WHOLE:
+        case SPRINT_LOADER_VALUE_ANGLE_FINE:
+            return angle >= INT_MIN && angle <= INT_MAX && sprint_angle_valid((sprint_angle) angle);
+        case SPRINT_LOADER_VALUE_THT_FORM:
+            return sprint_pad_tht_form_valid(number);
+        case SPRINT_LOADER_VALUE_TEXT_STYLE:
+            return sprint_text_style_valid(number);
+        case SPRINT_LOADER_VALUE_TEXT_THICKNESS:
+            return sprint_text_thickness_valid(number);
+        case SPRINT_LOADER_VALUE_THERMAL_TRACKS:
+            return number >= 0 && number <= 0xff;
+        case SPRINT_LOADER_VALUE_THERMAL_TRACKS_WIDTH:
+            return number >= 50 && number <= 300;
+        default:
+            return false;
+    }
+}
+
+sprint_keyword sprint_loader_word_internal(const char* source, int* offset, int end)
+{
+    int start = *offset;
+    while (*offset < end && ((source[*offset] >= 'A' && source[*offset] <= 'Z') ||
+                             (source[*offset] >= 'a' && source[*offset] <= 'z') || source[*offset] == '_'))
+        (*offset)++;
+    return *offset > start ? sprint_keyword_of(source + start, *offset - start) : SPRINT_KEYWORD_UNKNOWN;
+}
+
+bool sprint_loader_int_internal(const char* source, int* offset, int end, int* val)
+{
+    int start = *offset;
+    if (*offset < end && source[*offset] == '-')
+        (*offset)++;
+    while (*offset < end && source[*offset] >= '0' && source[*offset] <= '9')
+        (*offset)++;
+    return sprint_span_int(source + start, *offset - start, val) == SPRINT_ERROR_NONE;
+}
+
+void sprint_loader_run_internal(sprint_loader_chunk* chunk)
+{
+    // The results are tentative, so keep the diagnostics of this thread from being emitted
+    bool muted = sprint_error_mute(true);
+
+    // Create the tokenizer and parser for the chunk
+    sprint_tokenizer* tokenizer = sprint_tokenizer_from_range(chunk->source, chunk->start, chunk->end);
+    sprint_parser* parser = tokenizer != NULL ? sprint_parser_create(tokenizer) : NULL;
+    if (parser == NULL) {
+        if (tokenizer != NULL)
+            sprint_check(sprint_tokenizer_destroy(tokenizer));
+        chunk->error = SPRINT_ERROR_MEMORY;
+        sprint_error_mute(muted);
+        return;
+    }
+    sprint_check(sprint_parser_arena(parser, chunk->arena));
+
+    // Parse all elements of the chunk
+    sprint_error error = SPRINT_ERROR_NONE;
+    sprint_element* element;
+    while (true) {
+        // Read the element directly into a new slot and keep track of whether any needed to be salvaged
+        if (!sprint_chain(error, sprint_storage_push(&chunk->elements, &element)))
+            break;
+        bool salvaged = false;
+        error = sprint_parser_next_element_into(parser, element, &salvaged);
+        chunk->salvaged |= salvaged;
+        if (error != SPRINT_ERROR_NONE)
+            sprint_storage_remove(&chunk->elements);
+
+        // Handle EOF and other errors
+        if (error == SPRINT_ERROR_EOF)
+            error = SPRINT_ERROR_NONE;
+        else if (error == SPRINT_ERROR_NONE)
+            continue;
+        break;
+    }
+    chunk->error = error;
+
+    // Destroy the parser and thus also the tokenizer
+    sprint_check(sprint_parser_destroy(parser, true, NULL));
+    sprint_error_mute(muted);
+}
+
+void sprint_loader_discard_internal(sprint_loader_chunk* chunk)
+{
+    // Destroy all remaining elements, before releasing their blocks
+    sprint_storage_iterator iterator;
+    sprint_element* element;
+    sprint_check(sprint_storage_begin(&chunk->elements, 0, chunk->elements.count, &iterator));
+    while (sprint_storage_next(&iterator, &element))
+        sprint_check(sprint_element_destroy_contents(element));
+    sprint_check(sprint_storage_destroy(&chunk->elements));
+
+    // Release the elements allocated from the arena at once
+    if (chunk->arena != NULL) {
+        sprint_check(sprint_arena_destroy(chunk->arena));
+        chunk->arena = NULL;
+    }
+}
@@ -0,0 +1,52 @@
+//
+// SprintTrace: parallel element loader
+// Copyright 2022, Laminoid.com (Muessig & Muessig GbR).
+// Licensed under the terms and conditions of the GPLv3.
+//
+
+#ifndef SPRINTTRACE_LOADER_H
+#define SPRINTTRACE_LOADER_H
+
+#include "pcb.h"
+#include "list.h"
+#include "storage.h"
+#include "arena.h"
+#include "token.h"
+#include "errors.h"
+
+#include <stdbool.h>
+
+extern const int SPRINT_LOADER_CHUNK_SIZE;
+extern const int SPRINT_LOADER_THREADS_MAX;
+
+/**
+ * Determines the number of threads to load with by default, which is one per online processor.
+ * @return The number of threads, which is at least one.
+ */
+int sprint_loader_threads(void);
+/**
+ * Parses all elements of the input into the storage.
+ * Persistent sources are split into chunks at top-level element boundaries, which are parsed on separate threads.
+ * If any chunk needs to be salvaged or fails, the input is parsed again sequentially, so that all diagnostics
+ * and results are exactly the same as without splitting.
+ * @param tokenizer The tokenizer of the input, which must not have been read from yet.
+ * @param threads The maximum number of threads, or zero to use the default.
+ * @param elements The storage to add the parsed elements to.
+ * @param arena The arena to allocate the elements and their buffers from, or null to allocate them individually.
+ * @param salvaged The target reference to write the salvaged flag of the last parsed element to.
+ * @return No error returned on success.
+ */
+sprint_error sprint_loader_parse(sprint_tokenizer* tokenizer, int threads, sprint_storage* elements,
+                                 sprint_arena* arena, bool* salvaged);
+/**
+ * Indexes the top-level elements of the input in a single pass, without parsing them.
+ * This only follows the statements of the source, so elements may still fail to parse once they are decoded.
+ * Plain elements that are written exactly like Sprint-Layout writes them are checked to parse cleanly on the way.
+ * @param tokenizer The tokenizer of the input, which must be persistent and remains unread.
+ * @param entries The list of board entries to add an entry with the type and range of every element to.
+ * @return No error returned on success. If the source is not persistent, returns invalid state.
+ *         If it cannot be split into elements reliably, returns syntax.
+ */
+sprint_error sprint_loader_index(sprint_tokenizer* tokenizer, sprint_list* entries);
+
+#endif //SPRINTTRACE_LOADER_H
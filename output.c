@@ -6,22 +6,51 @@
 
 #include "output.h"
 #include "stringbuilder.h"
+#include "rope.h"
 #include "errors.h"
 
 #include <stdlib.h>
 #include <stdio.h>
 #include <stdbool.h>
 #include <stdarg.h>
+#include <stddef.h>
+#include <limits.h>
+#include <string.h>
 #include <errno.h>
 
+#ifdef WIN32
+#include <io.h>
+#else
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+const size_t SPRINT_OUTPUT_BUFFER_SIZE = 256 * 1024;
+
 static bool sprint_output_write_chr_str_internal(sprint_output* output, char chr);
+static bool sprint_output_write_chr_rope_internal(sprint_output* output, char chr);
 static bool sprint_output_write_chr_file_internal(sprint_output* output, char chr);
+static bool sprint_output_write_chr_descriptor_internal(sprint_output* output, char chr);
 static bool sprint_output_write_str_str_internal(sprint_output* output, const char* str);
+static bool sprint_output_write_str_rope_internal(sprint_output* output, const char* str);
 static bool sprint_output_write_str_file_internal(sprint_output* output, const char* str);
+static bool sprint_output_write_str_descriptor_internal(sprint_output* output, const char* str);
+static bool sprint_output_write_bytes_str_internal(sprint_output* output, const char* bytes, size_t length);
+static bool sprint_output_write_bytes_rope_internal(sprint_output* output, const char* bytes, size_t length);
+static bool sprint_output_write_bytes_file_internal(sprint_output* output, const char* bytes, size_t length);
+static bool sprint_output_write_bytes_descriptor_internal(sprint_output* output, const char* bytes, size_t length);
 static bool sprint_output_write_format_str_internal(sprint_output* output, const char* format, va_list args);
+static bool sprint_output_write_format_rope_internal(sprint_output* output, const char* format, va_list args);
 static bool sprint_output_write_format_file_internal(sprint_output* output, const char* format, va_list args);
+static bool sprint_output_write_format_descriptor_internal(sprint_output* output, const char* format, va_list args);
+static sprint_error sprint_output_put_segment_internal(const char* bytes, size_t length, void* output);
+static bool sprint_output_flush_file_internal(sprint_output* output);
+static bool sprint_output_flush_descriptor_internal(sprint_output* output);
+static bool sprint_output_drain_internal(sprint_output* output, const char* bytes, size_t length);
 static bool sprint_output_close_str_internal(sprint_output* output, char** contents);
+static bool sprint_output_close_rope_internal(sprint_output* output, char** contents);
 static bool sprint_output_close_file_internal(sprint_output* output, __attribute__((unused)) char** contents);
+static bool sprint_output_close_descriptor_internal(sprint_output* output, __attribute__((unused)) char** contents);
 
 sprint_output* sprint_output_create_str(int capacity)
 {
@@ -39,12 +68,38 @@ sprint_output* sprint_output_create_str(int capacity)
     output->builder = builder;
     output->write_chr = sprint_output_write_chr_str_internal;
     output->write_str = sprint_output_write_str_str_internal;
+    output->write_bytes = sprint_output_write_bytes_str_internal;
     output->write_format = sprint_output_write_format_str_internal;
     output->close = sprint_output_close_str_internal;
 
     return output;
 }
 
+sprint_output* sprint_output_create_rope(void)
+{
+    // Construct a new rope
+    sprint_rope* rope = sprint_rope_create();
+    if (rope == NULL)
+        return NULL;
+
+    // Allocate the memory
+    sprint_output* output = calloc(1, sizeof(*output));
+    if (output == NULL) {
+        sprint_check(sprint_rope_destroy(rope));
+        return NULL;
+    }
+
+    // Store the rope and the functions
+    output->rope = rope;
+    output->write_chr = sprint_output_write_chr_rope_internal;
+    output->write_str = sprint_output_write_str_rope_internal;
+    output->write_bytes = sprint_output_write_bytes_rope_internal;
+    output->write_format = sprint_output_write_format_rope_internal;
+    output->close = sprint_output_close_rope_internal;
+
+    return output;
+}
+
 sprint_output* sprint_output_create_file(FILE* stream, bool close)
 {
     if (stream == NULL) return NULL;
@@ -58,15 +113,55 @@ sprint_output* sprint_output_create_file(FILE* stream, bool close)
     output->file = stream;
     output->write_chr = sprint_output_write_chr_file_internal;
     output->write_str = sprint_output_write_str_file_internal;
+    output->write_bytes = sprint_output_write_bytes_file_internal;
     output->write_format = sprint_output_write_format_file_internal;
+    output->flush = sprint_output_flush_file_internal;
     output->close = close ? sprint_output_close_file_internal : NULL;
 
     return output;
 }
 
+sprint_output* sprint_output_create_descriptor(int descriptor, bool close)
+{
+    if (descriptor < 0) return NULL;
+
+    // Allocate the memory
+    sprint_output* output = calloc(1, sizeof(*output));
+    if (output == NULL)
+        return NULL;
+    output->buffered.buffer = malloc(SPRINT_OUTPUT_BUFFER_SIZE);
+    if (output->buffered.buffer == NULL) {
+        free(output);
+        return NULL;
+    }
+
+    // Store the descriptor and the functions, always closing the output to write what is left in the buffer
+    output->buffered.descriptor = descriptor;
+    output->buffered.owned = close;
+    output->write_chr = sprint_output_write_chr_descriptor_internal;
+    output->write_str = sprint_output_write_str_descriptor_internal;
+    output->write_bytes = sprint_output_write_bytes_descriptor_internal;
+    output->write_format = sprint_output_write_format_descriptor_internal;
+    output->flush = sprint_output_flush_descriptor_internal;
+    output->close = sprint_output_close_descriptor_internal;
+
+    return output;
+}
+
 sprint_error sprint_output_put_int(sprint_output* output, int val)
 {
-    return sprint_output_format(output, "%d", val);
+    char digits[11];
+    int length = sprint_stringbuilder_format_int(digits, val);
+    return sprint_output_put_bytes(output, digits, length);
+}
+
+sprint_error sprint_output_put_fixed(sprint_output* output, int whole, int fraction, int precision)
+{
+    if (fraction < 0 || precision < 0 || precision > 16) return SPRINT_ERROR_ARGUMENT_RANGE;
+
+    char digits[28];
+    int length = sprint_stringbuilder_format_fixed(digits, whole, fraction, precision);
+    return sprint_output_put_bytes(output, digits, length);
 }
 
 sprint_error sprint_output_put_chr(sprint_output* output, char chr)
@@ -85,6 +180,20 @@ sprint_error sprint_output_put_str(sprint_output* output, const char* str)
     return output->write_str(output, str) ? SPRINT_ERROR_NONE : SPRINT_ERROR_IO;
 }
 
+sprint_error sprint_output_put_bytes(sprint_output* output, const char* bytes, size_t length)
+{
+    if (output == NULL || bytes == NULL) return SPRINT_ERROR_ARGUMENT_NULL;
+    if (output->write_bytes == NULL) return SPRINT_ERROR_STATE_INVALID;
+
+    return output->write_bytes(output, bytes, length) ? SPRINT_ERROR_NONE : SPRINT_ERROR_IO;
+}
+
+sprint_error sprint_output_put_rope(sprint_output* output, sprint_rope* rope)
+{
+    if (output == NULL || rope == NULL) return SPRINT_ERROR_ARGUMENT_NULL;
+    return sprint_rethrow(sprint_rope_foreach_segment(rope, sprint_output_put_segment_internal, output));
+}
+
 sprint_error sprint_output_format(sprint_output* output, const char* format, ...)
 {
     if (output == NULL || format == NULL) return SPRINT_ERROR_ARGUMENT_NULL;
@@ -97,6 +206,14 @@ sprint_error sprint_output_format(sprint_output* output, const char* format, ...
     return success ? SPRINT_ERROR_NONE : SPRINT_ERROR_IO;
 }
 
+sprint_error sprint_output_flush(sprint_output* output)
+{
+    if (output == NULL) return SPRINT_ERROR_ARGUMENT_NULL;
+
+    // Outputs without a flush function do not buffer anything
+    return output->flush == NULL || output->flush(output) ? SPRINT_ERROR_NONE : SPRINT_ERROR_IO;
+}
+
 sprint_error sprint_output_destroy(sprint_output* output, char** contents)
 {
     if (output == NULL) return SPRINT_ERROR_ARGUMENT_NULL;
@@ -112,6 +229,11 @@ bool sprint_output_write_chr_str_internal(sprint_output* output, char chr)
     return sprint_check(sprint_stringbuilder_put_chr(output->builder, chr));
 }
 
+bool sprint_output_write_chr_rope_internal(sprint_output* output, char chr)
+{
+    return sprint_check(sprint_rope_put_chr(output->rope, chr));
+}
+
 bool sprint_output_write_chr_file_internal(sprint_output* output, char chr)
 {
     errno = 0;
@@ -122,11 +244,25 @@ bool sprint_output_write_chr_file_internal(sprint_output* output, char chr)
     return false;
 }
 
+bool sprint_output_write_chr_descriptor_internal(sprint_output* output, char chr)
+{
+    if (output->buffered.used >= SPRINT_OUTPUT_BUFFER_SIZE && !sprint_output_drain_internal(output, NULL, 0))
+        return false;
+
+    output->buffered.buffer[output->buffered.used++] = chr;
+    return true;
+}
+
 bool sprint_output_write_str_str_internal(sprint_output* output, const char* str)
 {
     return sprint_check(sprint_stringbuilder_put_str(output->builder, str));
 }
 
+bool sprint_output_write_str_rope_internal(sprint_output* output, const char* str)
+{
+    return sprint_check(sprint_rope_put_str(output->rope, str));
+}
+
 bool sprint_output_write_str_file_internal(sprint_output* output, const char* str)
 {
     errno = 0;
@@ -137,11 +273,62 @@ bool sprint_output_write_str_file_internal(sprint_output* output, const char* st
     return false;
 }
 
+bool sprint_output_write_str_descriptor_internal(sprint_output* output, const char* str)
+{
+    return sprint_output_write_bytes_descriptor_internal(output, str, strlen(str));
+}
+
+bool sprint_output_write_bytes_str_internal(sprint_output* output, const char* bytes, size_t length)
+{
+    if (length > INT_MAX) return false;
+
+    return sprint_check(sprint_stringbuilder_put_str_range(output->builder, bytes, (int) length));
+}
+
+bool sprint_output_write_bytes_rope_internal(sprint_output* output, const char* bytes, size_t length)
+{
+    return sprint_check(sprint_rope_put_bytes(output->rope, bytes, length));
+}
+
+bool sprint_output_write_bytes_file_internal(sprint_output* output, const char* bytes, size_t length)
+{
+    errno = 0;
+    if (fwrite(bytes, 1, length, output->file) == length)
+        return true;
+
+    sprint_throw_format(false, "error writing file: %s", strerror(errno));
+    return false;
+}
+
+bool sprint_output_write_bytes_descriptor_internal(sprint_output* output, const char* bytes, size_t length)
+{
+    // Copy the bytes into the buffer, if they fit
+    if (length <= SPRINT_OUTPUT_BUFFER_SIZE - output->buffered.used) {
+        memcpy(output->buffered.buffer + output->buffered.used, bytes, length);
+        output->buffered.used += length;
+        return true;
+    }
+
+    // Otherwise, write the buffer and the bytes together, unless the bytes are small enough to start the next buffer
+    if (length >= SPRINT_OUTPUT_BUFFER_SIZE / 2)
+        return sprint_output_drain_internal(output, bytes, length);
+    if (!sprint_output_drain_internal(output, NULL, 0))
+        return false;
+    memcpy(output->buffered.buffer, bytes, length);
+    output->buffered.used = length;
+    return true;
+}
+
 bool sprint_output_write_format_str_internal(sprint_output* output, const char* format, va_list args)
 {
     return sprint_check(sprint_stringbuilder_format_args(output->builder, format, args));
 }
 
+bool sprint_output_write_format_rope_internal(sprint_output* output, const char* format, va_list args)
+{
+    return sprint_check(sprint_rope_format_args(output->rope, format, args));
+}
+
 bool sprint_output_write_format_file_internal(sprint_output* output, const char* format, va_list args)
 {
     errno = 0;
@@ -152,6 +339,100 @@ bool sprint_output_write_format_file_internal(sprint_output* output, const char*
     return false;
 }
 
+bool sprint_output_write_format_descriptor_internal(sprint_output* output, const char* format, va_list args)
+{
+    // Format straight into the buffer, if it fits
+    va_list retry_args;
+    va_copy(retry_args, args);
+    size_t available = SPRINT_OUTPUT_BUFFER_SIZE - output->buffered.used;
+    int length = vsnprintf(output->buffered.buffer + output->buffered.used, available, format, args);
+    if (length < 0) {
+        va_end(retry_args);
+        return false;
+    }
+    if ((size_t) length < available) {
+        output->buffered.used += length;
+        va_end(retry_args);
+        return true;
+    }
+
+    // Otherwise, format it separately and put it then
+    char* formatted = malloc(length + 1);
+    bool success = formatted != NULL && vsnprintf(formatted, length + 1, format, retry_args) == length &&
+                   sprint_output_write_bytes_descriptor_internal(output, formatted, length);
+    va_end(retry_args);
+    free(formatted);
+    return success;
+}
+
+sprint_error sprint_output_put_segment_internal(const char* bytes, size_t length, void* output)
+{
+    return sprint_output_put_bytes(output, bytes, length);
+}
+
+bool sprint_output_flush_file_internal(sprint_output* output)
+{
+    return fflush(output->file) != EOF;
+}
+
+bool sprint_output_flush_descriptor_internal(sprint_output* output)
+{
+    return sprint_output_drain_internal(output, NULL, 0);
+}
+
+bool sprint_output_drain_internal(sprint_output* output, const char* bytes, size_t length)
+{
+    const char* parts[] = {output->buffered.buffer, bytes};
+    size_t lengths[] = {output->buffered.used, length};
+#ifdef WIN32
+    // Write the buffer and the bytes one after another
+    for (int part = 0; part < 2; part++) {
+        while (lengths[part] > 0) {
+            unsigned int chunk = lengths[part] > INT_MAX ? INT_MAX : (unsigned int) lengths[part];
+            int written = _write(output->buffered.descriptor, parts[part], chunk);
+            if (written < 0) {
+                sprint_throw_format(false, "error writing file: %s", strerror(errno));
+                return false;
+            }
+            parts[part] += written;
+            lengths[part] -= written;
+        }
+    }
+#else
+    // Write the buffer and the bytes with as few system calls as possible, which is usually one
+    struct iovec vectors[] = {
+            {.iov_base = (void*) parts[0], .iov_len = lengths[0]},
+            {.iov_base = (void*) parts[1], .iov_len = lengths[1]}
+    };
+    struct iovec* vector = vectors;
+    int count = 2;
+    while (count > 0) {
+        // Skip empty parts, which would not make any progress
+        if (vector->iov_len == 0) {
+            vector++;
+            count--;
+            continue;
+        }
+
+        ssize_t written = writev(output->buffered.descriptor, vector, count);
+        if (written < 0) {
+            if (errno == EINTR)
+                continue;
+            sprint_throw_format(false, "error writing file: %s", strerror(errno));
+            return false;
+        }
+        for (; count > 0 && (size_t) written >= vector->iov_len; vector++, count--)
+            written -= (ssize_t) vector->iov_len;
+        if (count > 0) {
+            vector->iov_base = (char*) vector->iov_base + written;
+            vector->iov_len -= written;
+        }
+    }
+#endif
+    output->buffered.used = 0;
+    return true;
+}
+
 bool sprint_output_close_str_internal(sprint_output* output, char** contents)
 {
     if (output->builder == NULL) return false;
@@ -167,6 +448,21 @@ bool sprint_output_close_str_internal(sprint_output* output, char** contents)
     return success;
 }
 
+bool sprint_output_close_rope_internal(sprint_output* output, char** contents)
+{
+    if (output->rope == NULL) return false;
+
+    bool success;
+    if (contents != NULL) {
+        *contents = sprint_rope_complete(output->rope);
+        success = sprint_assert(false, *contents != NULL);
+    } else
+        success = sprint_check(sprint_rope_destroy(output->rope));
+
+    output->rope = NULL;
+    return success;
+}
+
 bool sprint_output_close_file_internal(sprint_output* output, __attribute__((unused)) char** contents)
 {
     if (output->file == NULL) return false;
@@ -176,3 +472,23 @@ bool sprint_output_close_file_internal(sprint_output* output, __attribute__((unu
 
     return success;
 }
+
+bool sprint_output_close_descriptor_internal(sprint_output* output, __attribute__((unused)) char** contents)
+{
+    if (output->buffered.buffer == NULL) return false;
+
+    // Write what is left in the buffer
+    bool success = sprint_output_drain_internal(output, NULL, 0);
+    free(output->buffered.buffer);
+    output->buffered.buffer = NULL;
+
+    // Then close the descriptor, if it is owned
+    if (output->buffered.owned) {
+#ifdef WIN32
+        success &= _close(output->buffered.descriptor) == 0;
+#else
+        success &= close(output->buffered.descriptor) == 0;
+#endif
+    }
+    return success;
+}
@@ -8,32 +8,91 @@
 #define SPRINTTRACE_OUTPUT_H
 
 #include "stringbuilder.h"
+#include "rope.h"
 #include "errors.h"
 
 #include <stdlib.h>
 #include <stdio.h>
 #include <stdbool.h>
 #include <stdarg.h>
+#include <stddef.h>
+
+extern const size_t SPRINT_OUTPUT_BUFFER_SIZE;
 
 typedef struct sprint_output sprint_output;
 
 struct sprint_output {
     bool (*write_chr)(sprint_output* output, char chr);
     bool (*write_str)(sprint_output* output, const char* str);
+    bool (*write_bytes)(sprint_output* output, const char* bytes, size_t length);
     bool (*write_format)(sprint_output* output, const char* format, va_list args);
+    bool (*flush)(sprint_output* output);
     bool (*close)(sprint_output* output, char** contents);
     union {
         sprint_stringbuilder* builder;
+        sprint_rope* rope;
         FILE* file;
+        struct {
+            // The file descriptor, which is written to once the buffer is full
+            int descriptor;
+            bool owned;
+
+            // The buffered bytes, which have not been written yet
+            size_t used;
+            char* buffer;
+        } buffered;
     };
 };
 
 sprint_output* sprint_output_create_str(int capacity);
+/**
+ * Creates an output that collects everything in a rope, which never moves what has been put before.
+ * When the output is destroyed, the contents are joined into a single string only if they are requested.
+ * @return The output, or null if it could not be allocated.
+ */
+sprint_output* sprint_output_create_rope(void);
 sprint_output* sprint_output_create_file(FILE* stream, bool close);
+/**
+ * Creates an output that collects everything in a large buffer, which is written to a file descriptor at once.
+ * @param descriptor The file descriptor to write to.
+ * @param close Whether to close the file descriptor when the output is destroyed.
+ * @return The output, or null if it could not be allocated.
+ */
+sprint_output* sprint_output_create_descriptor(int descriptor, bool close);
 sprint_error sprint_output_put_int(sprint_output* output, int val);
+/**
+ * Puts a fixed-point number, which looks exactly like it would with "%d.%0*d".
+ * @param output The output instance.
+ * @param whole The integer part.
+ * @param fraction The fractional part, which must not be negative.
+ * @param precision The minimum number of fractional digits, which can be up to 16.
+ * @return No error returned on success.
+ */
+sprint_error sprint_output_put_fixed(sprint_output* output, int whole, int fraction, int precision);
 sprint_error sprint_output_put_chr(sprint_output* output, char chr);
 sprint_error sprint_output_put_str(sprint_output* output, const char* str);
+/**
+ * Puts a range of bytes, which need not be terminated.
+ * @param output The output instance.
+ * @param bytes The bytes to put.
+ * @param length The number of bytes to put.
+ * @return No error returned on success.
+ */
+sprint_error sprint_output_put_bytes(sprint_output* output, const char* bytes, size_t length);
+/**
+ * Puts the entire contents of a rope, segment by segment.
+ * @param output The output instance.
+ * @param rope The rope to put, which is left unchanged.
+ * @return No error returned on success.
+ */
+sprint_error sprint_output_put_rope(sprint_output* output, sprint_rope* rope);
 sprint_error sprint_output_format(sprint_output* output, const char* format, ...);
+/**
+ * Writes everything that has been buffered so far, if the output is buffered.
+ * @param output The output instance.
+ * @return No error returned on success.
+ */
+sprint_error sprint_output_flush(sprint_output* output);
 sprint_error sprint_output_destroy(sprint_output* output, char** contents);
 
 #endif //SPRINTTRACE_OUTPUT_H
@@ -8,16 +8,29 @@
 #include "primitives.h"
 #include "elements.h"
 #include "list.h"
+#include "arena.h"
 #include "stringbuilder.h"
 #include "token.h"
+#include "keyword.h"
 #include "errors.h"
 
 #include <string.h>
 #include <stdlib.h>
 
+// The lists that the points, connections and children of elements are collected in
+SPRINT_LIST_DEFINE(sprint_tuple, tuple)
+SPRINT_LIST_DEFINE(int, int)
+SPRINT_LIST_DEFINE(sprint_element, element)
+
 char* sprint_parser_statement_name(sprint_statement* statement)
 {
-    return statement != NULL ? statement->name : NULL;
+    if (statement == NULL) return NULL;
+    return statement->name != NULL ? statement->name : statement->buffer;
+}
+
+sprint_keyword sprint_parser_statement_keyword(sprint_statement* statement)
+{
+    return statement != NULL ? statement->keyword : SPRINT_KEYWORD_UNKNOWN;
 }
 
 bool sprint_parser_statement_flags(sprint_statement* statement, bool any, sprint_statement_flags flags)
@@ -48,13 +61,13 @@ sprint_parser* sprint_parser_create(sprint_tokenizer* tokenizer)
 {
     if (tokenizer == NULL || tokenizer->read == NULL) return NULL;
 
-    // Create the builder
-    sprint_stringbuilder* builder = sprint_stringbuilder_create(15);
+    // Create the builder, which holds almost all tokens inline
+    sprint_stringbuilder* builder = sprint_stringbuilder_create_inline(64);
     if (builder == NULL)
         return NULL;
 
     // Create the parser
-    sprint_parser* parser = calloc(1, sizeof(*tokenizer));
+    sprint_parser* parser = calloc(1, sizeof(*parser));
     if (parser == NULL) {
         sprint_check(sprint_stringbuilder_destroy(builder));
         return NULL;
@@ -66,6 +79,25 @@ sprint_parser* sprint_parser_create(sprint_tokenizer* tokenizer)
     return parser;
 }
 
+sprint_error sprint_parser_arena(sprint_parser* parser, sprint_arena* arena)
+{
+    if (parser == NULL) return SPRINT_ERROR_ARGUMENT_NULL;
+
+    parser->arena = arena;
+    return SPRINT_ERROR_NONE;
+}
+
+sprint_error sprint_parser_filter(sprint_parser* parser, const sprint_element_filter* filter)
+{
+    if (parser == NULL) return SPRINT_ERROR_ARGUMENT_NULL;
+
+    if (filter != NULL)
+        parser->filter = *filter;
+    else
+        memset(&parser->filter, 0, sizeof(parser->filter));
+    return SPRINT_ERROR_NONE;
+}
+
 sprint_error sprint_parser_token(sprint_parser* parser, sprint_token* token)
 {
     if (parser == NULL || token == NULL) return SPRINT_ERROR_ARGUMENT_NULL;
@@ -79,11 +111,15 @@ sprint_error sprint_parser_origin(sprint_parser* parser, sprint_source_origin* o
     if (parser == NULL || origin == NULL) return SPRINT_ERROR_ARGUMENT_NULL;
 
     *origin = parser->token.origin;
-    return SPRINT_ERROR_NONE;
+    return sprint_rethrow(sprint_tokenizer_resolve(parser->tokenizer, origin));
 }
 
 static sprint_error sprint_token_unexpected_internal(sprint_parser* parser, bool warning)
 {
+    // Resolving the position may index the entire source, which is wasted if the diagnostic is not shown
+    if (sprint_error_is_muted())
+        return SPRINT_ERROR_NONE;
+
     sprint_token* token = &parser->token;
     bool invalid = token->type == SPRINT_TOKEN_TYPE_INVALID;
     sprint_stringbuilder* builder = sprint_stringbuilder_of(invalid ? "invalid" : "unexpected");
@@ -97,7 +133,11 @@ static sprint_error sprint_token_unexpected_internal(sprint_parser* parser, bool
     sprint_chain(error, sprint_stringbuilder_put_str(builder, " at "));
     if (token->origin.source != NULL)
         sprint_chain(error, sprint_stringbuilder_format(builder, "%s:", token->origin.source));
-    sprint_chain(error, sprint_stringbuilder_format(builder, "%d:%d", token->origin.line, token->origin.pos));
+
+    // Resolve the position, which may only be known by its offset
+    sprint_source_origin origin = token->origin;
+    sprint_check(sprint_tokenizer_resolve(parser->tokenizer, &origin));
+    sprint_chain(error, sprint_stringbuilder_format(builder, "%d:%d", origin.line, origin.pos));
 
     // Append the contents
     char* contents = NULL;
@@ -120,10 +160,33 @@ static sprint_error sprint_token_unexpected_internal(sprint_parser* parser, bool
     return SPRINT_ERROR_NONE;
 }
 
+static sprint_error sprint_parser_statement_name_internal(sprint_parser* parser, sprint_statement* statement)
+{
+    const char* span;
+    int length;
+    sprint_error error = SPRINT_ERROR_NONE;
+    if (!sprint_chain(error, sprint_token_span(&parser->token, parser->builder, &span, &length)))
+        return sprint_rethrow(error);
+    if (length < 1) return SPRINT_ERROR_ARGUMENT_INCOMPLETE;
+
+    // Recognize the keyword directly from the span
+    statement->keyword = sprint_keyword_of(span, length);
+
+    // Copy the name into the inline buffer, only allocating it if it does not fit
+    if ((size_t) length >= sizeof(statement->buffer))
+        return sprint_rethrow(sprint_token_word(&parser->token, parser->builder, &statement->name));
+    memcpy(statement->buffer, span, length);
+    statement->buffer[length] = 0;
+    return SPRINT_ERROR_NONE;
+}
+
 sprint_error sprint_parser_next_statement(sprint_parser* parser, sprint_statement* statement, bool sync)
 {
     if (parser == NULL || statement == NULL) return SPRINT_ERROR_ARGUMENT_NULL;
 
+    // Clear the statement, so that it can be destroyed even if no word is found
+    memset(statement, 0, sizeof(*statement));
+
     // Keep seeking until a token is found
     sprint_error error = SPRINT_ERROR_NONE;
     bool skipped = false;
@@ -155,7 +218,7 @@ sprint_error sprint_parser_next_statement(sprint_parser* parser, sprint_statemen
                 // Now that a word was found, set the first flag if applicable and store the name
                 if (!parser->subsequent)
                     statement->flags |= SPRINT_STATEMENT_FLAG_FIRST;
-                if (!sprint_chain(error, sprint_token_word(token, parser->builder, &statement->name)))
+                if (!sprint_chain(error, sprint_parser_statement_name_internal(parser, statement)))
                     return sprint_rethrow(error);
 
                 // Set the name flag
@@ -282,6 +345,41 @@ sprint_error sprint_parser_next_statement(sprint_parser* parser, sprint_statemen
     }
 }
 
+static sprint_error sprint_parser_skip_internal(sprint_parser* parser, int depth)
+{
+    // Skip the rest of the statement, and further statements until the given nesting depth is closed again
+    sprint_token* token = &parser->token;
+    while (parser->subsequent || depth > 0) {
+        sprint_error error = sprint_tokenizer_next(parser->tokenizer, token, parser->builder);
+        if (error == SPRINT_ERROR_EOF || !sprint_check(error))
+            return sprint_rethrow(error);
+
+        // Track the nesting by the keywords starting statements, without validating anything else
+        const char* span;
+        int length;
+        if (!parser->subsequent && token->type == SPRINT_TOKEN_TYPE_WORD &&
+            sprint_check(sprint_token_span(token, parser->builder, &span, &length))) {
+            switch (sprint_keyword_of(span, length)) {
+                case SPRINT_KEYWORD_BEGIN_COMPONENT:
+                case SPRINT_KEYWORD_GROUP:
+                    depth++;
+                    break;
+                case SPRINT_KEYWORD_END_COMPONENT:
+                case SPRINT_KEYWORD_END_GROUP:
+                    depth--;
+                    break;
+                default:
+                    break;
+            }
+        }
+        parser->subsequent = token->type != SPRINT_TOKEN_TYPE_STATEMENT_TERMINATOR;
+    }
+
+    // Clear the value flag
+    parser->value = false;
+    return SPRINT_ERROR_NONE;
+}
+
 static sprint_error sprint_parser_next_internal(sprint_parser* parser, sprint_token_type type)
 {
     // Get the next token and reset the subsequent flag
@@ -334,8 +432,14 @@ sprint_error sprint_parser_next_int(sprint_parser* parser, int* val)
     if (parser == NULL || val == NULL) return SPRINT_ERROR_ARGUMENT_NULL;
 
     sprint_error error = SPRINT_ERROR_NONE;
-    sprint_chain(error, sprint_parser_next_internal(parser, SPRINT_TOKEN_TYPE_NUMBER));
-    sprint_chain(error, sprint_token_int(&parser->token, parser->builder, val));
+    if (!sprint_chain(error, sprint_parser_next_internal(parser, SPRINT_TOKEN_TYPE_NUMBER)))
+        return sprint_rethrow(error);
+
+    // Numbers out of range are invalid like any other invalid value, so that the element can still be salvaged
+    sprint_error conversion = sprint_token_int(&parser->token, parser->builder, val);
+    if (conversion == SPRINT_ERROR_OVERFLOW)
+        return SPRINT_ERROR_SYNTAX;
+    sprint_chain(error, conversion);
     return sprint_rethrow(error);
 }
 
@@ -399,9 +503,22 @@ sprint_error sprint_parser_next_str(sprint_parser* parser, char** str)
     if (parser == NULL || str == NULL) return SPRINT_ERROR_ARGUMENT_NULL;
 
     sprint_error error = SPRINT_ERROR_NONE;
-    sprint_chain(error, sprint_parser_next_internal(parser, SPRINT_TOKEN_TYPE_STRING));
-    sprint_chain(error, sprint_token_str(&parser->token, parser->builder, str));
-    return sprint_rethrow(error);
+    if (!sprint_chain(error, sprint_parser_next_internal(parser, SPRINT_TOKEN_TYPE_STRING)) || parser->arena == NULL) {
+        sprint_chain(error, sprint_token_str(&parser->token, parser->builder, str));
+        return sprint_rethrow(error);
+    }
+
+    // Copy the string into the arena
+    const char* span;
+    int length;
+    if (!sprint_chain(error, sprint_token_span(&parser->token, parser->builder, &span, &length)))
+        return sprint_rethrow(error);
+    *str = sprint_arena_alloc(parser->arena, length + 1);
+    if (*str == NULL)
+        return SPRINT_ERROR_MEMORY;
+    memcpy(*str, span, length);
+    (*str)[length] = 0;
+    return SPRINT_ERROR_NONE;
 }
 
 static sprint_error sprint_parser_next_uint(sprint_parser* parser, int* val)
@@ -417,6 +534,10 @@ static sprint_error sprint_parser_next_layer(sprint_parser* parser, sprint_layer
     sprint_error error = SPRINT_ERROR_NONE;
     if (sprint_chain(error, sprint_parser_next_int(parser, (int*) layer)) && !sprint_layer_valid(*layer))
         return SPRINT_ERROR_SYNTAX;
+
+    // Mark the element to be skipped, if it is on a layer that is filtered out
+    if (error == SPRINT_ERROR_NONE && parser->layers != 0 && (parser->layers & 1 << *layer) == 0)
+        parser->filtered = true;
     return error;
 }
 
@@ -447,6 +568,12 @@ static sprint_error sprint_parser_next_text_thickness(sprint_parser* parser, spr
 
 static sprint_error sprint_parser_next_value_internal(sprint_parser* parser, sprint_statement* statement, bool* salvaged)
 {
+    // Skip the remaining properties of an element that is filtered out
+    if (parser->filtered) {
+        sprint_error error = sprint_parser_skip_internal(parser, 0);
+        return error != SPRINT_ERROR_NONE ? error : SPRINT_ERROR_EOS;
+    }
+
     // Keep reading until a valid statement or a terminator is found
     while (parser->subsequent) {
         // Read the next statement
@@ -490,15 +617,16 @@ static sprint_error sprint_parser_next_track_internal(sprint_parser* parser, spr
     if (!sprint_chain(error, sprint_track_default(element, true)))
         return sprint_rethrow(error);
     element->parsed = true;
+    element->pooled = parser->arena != NULL;
 
     // Keep track of found properties
     bool found_layer = false, found_width = false, found_clear = false, found_cutout = false, found_soldermask = false,
             found_flat_start = false, found_flat_end = false, found_name = false;
 
     // Keep a list of points
-    sprint_list* list = sprint_list_create(sizeof(*element->track.points), 16);
-    if (list == NULL)
-        return SPRINT_ERROR_MEMORY;
+    sprint_list_tuple list = {0};
+    if (!sprint_chain(error, sprint_list_tuple_reserve(&list, 16)))
+        return sprint_rethrow(error);
 
     // Read all element properties
     sprint_statement statement;
@@ -510,61 +638,75 @@ static sprint_error sprint_parser_next_track_internal(sprint_parser* parser, spr
             break;
         }
         if (!sprint_check(error)) {
-            sprint_check(sprint_list_destroy(list));
+            sprint_list_tuple_destroy(&list);
             return sprint_rethrow(error);
         }
 
         // Determine the statement name
         bool already_found = false;
-        if (strcasecmp(statement.name, "P") == 0) {
-            sprint_tuple tuple;
-            if (sprint_parser_statement_flags(&statement, true, SPRINT_STATEMENT_FLAG_INDEX) &&
-                sprint_parser_statement_index(&statement) == sprint_list_count(list) &&
-                sprint_chain(error, sprint_parser_next_tuple(parser, &tuple)))
-                sprint_chain(error, sprint_list_add(list, &tuple));
-        } else if (sprint_parser_statement_flags(&statement, true, SPRINT_STATEMENT_FLAG_INDEX)) {
+        if (statement.keyword != SPRINT_KEYWORD_P && sprint_parser_statement_flags(&statement, true, SPRINT_STATEMENT_FLAG_INDEX)) {
             error = SPRINT_ERROR_SYNTAX;
-            sprint_throw_format(false, "unexpected property index: %s%d", statement.name, statement.index);
-        } else if (strcasecmp(statement.name, "LAYER") == 0) {
-            if (found_layer)
-                already_found = true;
-            found_layer |= sprint_chain(error, sprint_parser_next_layer(parser, &element->track.layer));
-        } else if (strcasecmp(statement.name, "WIDTH") == 0) {
-            if (found_width)
-                already_found = true;
-            found_width |= sprint_chain(error, sprint_parser_next_size(parser, &element->track.width));
-        } else if (strcasecmp(statement.name, "CLEAR") == 0) {
-            if (found_clear)
-                already_found = true;
-            found_clear |= sprint_chain(error, sprint_parser_next_size(parser, &element->track.clear));
-        } else if (strcasecmp(statement.name, "CUTOUT") == 0) {
-            if (found_cutout)
-                already_found = true;
-            found_cutout |= sprint_chain(error, sprint_parser_next_bool(parser, &element->track.cutout));
-        } else if (strcasecmp(statement.name, "SOLDERMASK") == 0) {
-            if (found_soldermask)
-                already_found = true;
-            found_soldermask |= sprint_chain(error, sprint_parser_next_bool(parser, &element->track.soldermask));
-        } else if (strcasecmp(statement.name, "FLATSTART") == 0) {
-            if (found_flat_start)
-                already_found = true;
-            found_flat_start |= sprint_chain(error, sprint_parser_next_bool(parser, &element->track.flat_start));
-        } else if (strcasecmp(statement.name, "FLATEND") == 0) {
-            if (found_flat_end)
-                already_found = true;
-            found_flat_end |= sprint_chain(error, sprint_parser_next_bool(parser, &element->track.flat_end));
-        } else if (strcasecmp(statement.name, "NAME") == 0) {
-            if (found_name)
-                already_found = true;
-            found_name |= sprint_chain(error, sprint_parser_next_str(parser, &element->track.name));
+            sprint_throw_format(false, "unexpected property index: %s%d", sprint_parser_statement_name(&statement), statement.index);
         } else {
-            error = SPRINT_ERROR_SYNTAX;
-            sprint_throw_format(false, "unknown property: %s", statement.name);
+            switch (statement.keyword) {
+                case SPRINT_KEYWORD_P: {
+                    sprint_tuple tuple;
+                    if (sprint_parser_statement_flags(&statement, true, SPRINT_STATEMENT_FLAG_INDEX) &&
+                        sprint_parser_statement_index(&statement) == list.count &&
+                        sprint_chain(error, sprint_parser_next_tuple(parser, &tuple)))
+                        sprint_chain(error, sprint_list_tuple_add(&list, tuple));
+                    break;
+                }
+                case SPRINT_KEYWORD_LAYER:
+                    if (found_layer)
+                        already_found = true;
+                    found_layer |= sprint_chain(error, sprint_parser_next_layer(parser, &element->track.layer));
+                    break;
+                case SPRINT_KEYWORD_WIDTH:
+                    if (found_width)
+                        already_found = true;
+                    found_width |= sprint_chain(error, sprint_parser_next_size(parser, &element->track.width));
+                    break;
+                case SPRINT_KEYWORD_CLEAR:
+                    if (found_clear)
+                        already_found = true;
+                    found_clear |= sprint_chain(error, sprint_parser_next_size(parser, &element->track.clear));
+                    break;
+                case SPRINT_KEYWORD_CUTOUT:
+                    if (found_cutout)
+                        already_found = true;
+                    found_cutout |= sprint_chain(error, sprint_parser_next_bool(parser, &element->track.cutout));
+                    break;
+                case SPRINT_KEYWORD_SOLDERMASK:
+                    if (found_soldermask)
+                        already_found = true;
+                    found_soldermask |= sprint_chain(error, sprint_parser_next_bool(parser, &element->track.soldermask));
+                    break;
+                case SPRINT_KEYWORD_FLATSTART:
+                    if (found_flat_start)
+                        already_found = true;
+                    found_flat_start |= sprint_chain(error, sprint_parser_next_bool(parser, &element->track.flat_start));
+                    break;
+                case SPRINT_KEYWORD_FLATEND:
+                    if (found_flat_end)
+                        already_found = true;
+                    found_flat_end |= sprint_chain(error, sprint_parser_next_bool(parser, &element->track.flat_end));
+                    break;
+                case SPRINT_KEYWORD_NAME:
+                    if (found_name)
+                        already_found = true;
+                    found_name |= sprint_chain(error, sprint_parser_next_str(parser, &element->track.name));
+                    break;
+                default:
+                    error = SPRINT_ERROR_SYNTAX;
+                    sprint_throw_format(false, "unknown property: %s", sprint_parser_statement_name(&statement));
+                    break;
+            }
         }
 
         // Handle already found properties
         if (already_found)
-            sprint_warning_format("overwriting duplicate property: %s", statement.name);
+            sprint_warning_format("overwriting duplicate property: %s", sprint_parser_statement_name(&statement));
 
         // Destroy the statement
         sprint_check(sprint_parser_statement_destroy(&statement));
@@ -578,19 +720,25 @@ static sprint_error sprint_parser_next_track_internal(sprint_parser* parser, spr
 
         // All other errors stop processing
         if (error != SPRINT_ERROR_NONE) {
-            sprint_check(sprint_list_destroy(list));
+            sprint_list_tuple_destroy(&list);
             return sprint_rethrow(error);
         }
     }
 
+    // Discard the element, if it is on a layer that is filtered out
+    if (parser->filtered) {
+        sprint_list_tuple_destroy(&list);
+        return SPRINT_ERROR_NONE;
+    }
+
     // Make sure that there are at least two points and all properties
-    if (!found_layer | !found_width | sprint_list_count(list) < 2) {
+    if (!found_layer | !found_width | list.count < 2) {
         sprint_throw_format(false, "incomplete element: %s", sprint_element_type_to_keyword(SPRINT_ELEMENT_TRACK, false));
         error = SPRINT_ERROR_SYNTAX;
     }
 
     // Complete the list and check verify full validity
-    if (sprint_chain(error, sprint_list_complete(list, &element->track.num_points, (void*) &element->track.points)) &&
+    if (sprint_chain(error, sprint_list_tuple_complete(&list, parser->arena, &element->track.num_points, &element->track.points)) &&
         !sprint_assert(false, sprint_track_valid(&element->track)))
         error = SPRINT_ERROR_ASSERTION;
 
@@ -604,6 +752,7 @@ static sprint_error sprint_parser_next_pad_tht_internal(sprint_parser* parser, s
     if (!sprint_chain(error, sprint_pad_tht_default(element, true)))
         return sprint_rethrow(error);
     element->parsed = true;
+    element->pooled = parser->arena != NULL;
 
     // Keep track of found properties
     bool found_layer = false, found_position = false, found_size = false, found_drill = false, found_form = false,
@@ -612,9 +761,9 @@ static sprint_error sprint_parser_next_pad_tht_internal(sprint_parser* parser, s
             found_thermal_tracks_individual = false, found_name = false;
 
     // Keep a list of connections
-    sprint_list* list = sprint_list_create(sizeof(*element->pad_tht.link.connections), 8);
-    if (list == NULL)
-        return SPRINT_ERROR_MEMORY;
+    sprint_list_int list = {0};
+    if (!sprint_chain(error, sprint_list_int_reserve(&list, 8)))
+        return sprint_rethrow(error);
 
     // Read all element properties
     sprint_statement statement;
@@ -626,90 +775,111 @@ static sprint_error sprint_parser_next_pad_tht_internal(sprint_parser* parser, s
             break;
         }
         if (!sprint_check(error)) {
-            sprint_check(sprint_list_destroy(list));
+            sprint_list_int_destroy(&list);
             return sprint_rethrow(error);
         }
 
         // Determine the statement name
         bool already_found = false;
-        if (strcasecmp(statement.name, "CON") == 0) {
-            int id = 0;
-            if (sprint_parser_statement_flags(&statement, true, SPRINT_STATEMENT_FLAG_INDEX) &&
-                sprint_parser_statement_index(&statement) == sprint_list_count(list) &&
-                sprint_chain(error, sprint_parser_next_uint(parser, &id)))
-                sprint_chain(error, sprint_list_add(list, &id));
-        } else if (sprint_parser_statement_flags(&statement, true, SPRINT_STATEMENT_FLAG_INDEX)) {
+        if (statement.keyword != SPRINT_KEYWORD_CON && sprint_parser_statement_flags(&statement, true, SPRINT_STATEMENT_FLAG_INDEX)) {
             error = SPRINT_ERROR_SYNTAX;
-            sprint_throw_format(false, "unexpected property index: %s%d", statement.name, statement.index);
-        } else if (strcasecmp(statement.name, "LAYER") == 0) {
-            if (found_layer)
-                already_found = true;
-            found_layer |= sprint_chain(error, sprint_parser_next_layer(parser, &element->pad_tht.layer));
-        } else if (strcasecmp(statement.name, "POS") == 0) {
-            if (found_position)
-                already_found = true;
-            found_position |= sprint_chain(error, sprint_parser_next_tuple(parser, &element->pad_tht.position));
-        } else if (strcasecmp(statement.name, "SIZE") == 0) {
-            if (found_size)
-                already_found = true;
-            found_size |= sprint_chain(error, sprint_parser_next_size(parser, &element->pad_tht.size));
-        } else if (strcasecmp(statement.name, "DRILL") == 0) {
-            if (found_drill)
-                already_found = true;
-            found_drill |= sprint_chain(error, sprint_parser_next_size(parser, &element->pad_tht.drill));
-        } else if (strcasecmp(statement.name, "FORM") == 0) {
-            if (found_form)
-                already_found = true;
-            found_form |= sprint_chain(error, sprint_parser_next_tht_form(parser, &element->pad_tht.form));
-        } else if (strcasecmp(statement.name, "PAD_ID") == 0) {
-            if (found_id)
-                already_found = true;
-            found_id |= sprint_chain(error, sprint_parser_next_uint(parser, &element->pad_tht.link.id));
-            element->pad_tht.link.has_id = found_id;
-        } else if (strcasecmp(statement.name, "CLEAR") == 0) {
-            if (found_clear)
-                already_found = true;
-            found_clear |= sprint_chain(error, sprint_parser_next_size(parser, &element->pad_tht.clear));
-        } else if (strcasecmp(statement.name, "SOLDERMASK") == 0) {
-            if (found_soldermask)
-                already_found = true;
-            found_soldermask |= sprint_chain(error, sprint_parser_next_bool(parser, &element->pad_tht.soldermask));
-        } else if (strcasecmp(statement.name, "ROTATION") == 0) {
-            if (found_rotation)
-                already_found = true;
-            found_rotation |= sprint_chain(error, sprint_parser_next_angle(parser, &element->pad_tht.rotation, SPRINT_PRIM_FORMAT_ANGLE_COARSE));
-        } else if (strcasecmp(statement.name, "VIA") == 0) {
-            if (found_via)
-                already_found = true;
-            found_via |= sprint_chain(error, sprint_parser_next_bool(parser, &element->pad_tht.via));
-        } else if (strcasecmp(statement.name, "THERMAL") == 0) {
-            if (found_thermal)
-                already_found = true;
-            found_thermal |= sprint_chain(error, sprint_parser_next_bool(parser, &element->pad_tht.thermal));
-        } else if (strcasecmp(statement.name, "THERMAL_TRACKS") == 0) {
-            if (found_thermal_tracks)
-                already_found = true;
-            found_thermal_tracks |= sprint_chain(error, sprint_parser_next_int(parser, &element->pad_tht.thermal_tracks));
-        } else if (strcasecmp(statement.name, "THERMAL_TRACKS_WIDTH") == 0) {
-            if (found_thermal_tracks_width)
-                already_found = true;
-            found_thermal_tracks_width |= sprint_chain(error, sprint_parser_next_uint(parser, &element->pad_tht.thermal_tracks_width));
-        } else if (strcasecmp(statement.name, "THERMAL_TRACKS_INDIVIDUAL") == 0) {
-            if (found_thermal_tracks_individual)
-                already_found = true;
-            found_thermal_tracks_individual |= sprint_chain(error, sprint_parser_next_bool(parser, &element->pad_tht.thermal_tracks_individual));
-        } else if (strcasecmp(statement.name, "NAME") == 0) {
-            if (found_name)
-                already_found = true;
-            found_name |= sprint_chain(error, sprint_parser_next_str(parser, &element->pad_tht.name));
+            sprint_throw_format(false, "unexpected property index: %s%d", sprint_parser_statement_name(&statement), statement.index);
         } else {
-            error = SPRINT_ERROR_SYNTAX;
-            sprint_throw_format(false, "unknown property: %s", statement.name);
+            switch (statement.keyword) {
+                case SPRINT_KEYWORD_CON: {
+                    int id = 0;
+                    if (sprint_parser_statement_flags(&statement, true, SPRINT_STATEMENT_FLAG_INDEX) &&
+                        sprint_parser_statement_index(&statement) == list.count &&
+                        sprint_chain(error, sprint_parser_next_uint(parser, &id)))
+                        sprint_chain(error, sprint_list_int_add(&list, id));
+                    break;
+                }
+                case SPRINT_KEYWORD_LAYER:
+                    if (found_layer)
+                        already_found = true;
+                    found_layer |= sprint_chain(error, sprint_parser_next_layer(parser, &element->pad_tht.layer));
+                    break;
+                case SPRINT_KEYWORD_POS:
+                    if (found_position)
+                        already_found = true;
+                    found_position |= sprint_chain(error, sprint_parser_next_tuple(parser, &element->pad_tht.position));
+                    break;
+                case SPRINT_KEYWORD_SIZE:
+                    if (found_size)
+                        already_found = true;
+                    found_size |= sprint_chain(error, sprint_parser_next_size(parser, &element->pad_tht.size));
+                    break;
+                case SPRINT_KEYWORD_DRILL:
+                    if (found_drill)
+                        already_found = true;
+                    found_drill |= sprint_chain(error, sprint_parser_next_size(parser, &element->pad_tht.drill));
+                    break;
+                case SPRINT_KEYWORD_FORM:
+                    if (found_form)
+                        already_found = true;
+                    found_form |= sprint_chain(error, sprint_parser_next_tht_form(parser, &element->pad_tht.form));
+                    break;
+                case SPRINT_KEYWORD_PAD_ID:
+                    if (found_id)
+                        already_found = true;
+                    found_id |= sprint_chain(error, sprint_parser_next_uint(parser, &element->pad_tht.link.id));
+                    element->pad_tht.link.has_id = found_id;
+                    break;
+                case SPRINT_KEYWORD_CLEAR:
+                    if (found_clear)
+                        already_found = true;
+                    found_clear |= sprint_chain(error, sprint_parser_next_size(parser, &element->pad_tht.clear));
+                    break;
+                case SPRINT_KEYWORD_SOLDERMASK:
+                    if (found_soldermask)
+                        already_found = true;
+                    found_soldermask |= sprint_chain(error, sprint_parser_next_bool(parser, &element->pad_tht.soldermask));
+                    break;
+                case SPRINT_KEYWORD_ROTATION:
+                    if (found_rotation)
+                        already_found = true;
+                    found_rotation |= sprint_chain(error, sprint_parser_next_angle(parser, &element->pad_tht.rotation, SPRINT_PRIM_FORMAT_ANGLE_COARSE));
+                    break;
+                case SPRINT_KEYWORD_VIA:
+                    if (found_via)
+                        already_found = true;
+                    found_via |= sprint_chain(error, sprint_parser_next_bool(parser, &element->pad_tht.via));
+                    break;
+                case SPRINT_KEYWORD_THERMAL:
+                    if (found_thermal)
+                        already_found = true;
+                    found_thermal |= sprint_chain(error, sprint_parser_next_bool(parser, &element->pad_tht.thermal));
+                    break;
+                case SPRINT_KEYWORD_THERMAL_TRACKS:
+                    if (found_thermal_tracks)
+                        already_found = true;
+                    found_thermal_tracks |= sprint_chain(error, sprint_parser_next_int(parser, &element->pad_tht.thermal_tracks));
+                    break;
+                case SPRINT_KEYWORD_THERMAL_TRACKS_WIDTH:
+                    if (found_thermal_tracks_width)
+                        already_found = true;
+                    found_thermal_tracks_width |= sprint_chain(error, sprint_parser_next_uint(parser, &element->pad_tht.thermal_tracks_width));
+                    break;
+                case SPRINT_KEYWORD_THERMAL_TRACKS_INDIVIDUAL:
+                    if (found_thermal_tracks_individual)
+                        already_found = true;
+                    found_thermal_tracks_individual |= sprint_chain(error, sprint_parser_next_bool(parser, &element->pad_tht.thermal_tracks_individual));
+                    break;
+                case SPRINT_KEYWORD_NAME:
+                    if (found_name)
+                        already_found = true;
+                    found_name |= sprint_chain(error, sprint_parser_next_str(parser, &element->pad_tht.name));
+                    break;
+                default:
+                    error = SPRINT_ERROR_SYNTAX;
+                    sprint_throw_format(false, "unknown property: %s", sprint_parser_statement_name(&statement));
+                    break;
+            }
         }
 
         // Handle already found properties
         if (already_found)
-            sprint_warning_format("overwriting duplicate property: %s", statement.name);
+            sprint_warning_format("overwriting duplicate property: %s", sprint_parser_statement_name(&statement));
 
         // Destroy the statement
         sprint_check(sprint_parser_statement_destroy(&statement));
@@ -723,11 +893,17 @@ static sprint_error sprint_parser_next_pad_tht_internal(sprint_parser* parser, s
 
         // All other errors stop processing
         if (error != SPRINT_ERROR_NONE) {
-            sprint_check(sprint_list_destroy(list));
+            sprint_list_int_destroy(&list);
             return sprint_rethrow(error);
         }
     }
 
+    // Discard the element, if it is on a layer that is filtered out
+    if (parser->filtered) {
+        sprint_list_int_destroy(&list);
+        return SPRINT_ERROR_NONE;
+    }
+
     // Make sure that there are all properties
     if (!found_layer | !found_position | !found_size | !found_drill | !found_form |
         (element->pad_tht.thermal & (!found_thermal_tracks | !found_thermal_tracks_width | !found_thermal_tracks_individual))) {
@@ -736,8 +912,8 @@ static sprint_error sprint_parser_next_pad_tht_internal(sprint_parser* parser, s
     }
 
     // Complete the list and check verify full validity
-    if (sprint_chain(error, sprint_list_complete(list, &element->pad_tht.link.num_connections,
-                                                 (void*) &element->pad_tht.link.connections)) &&
+    if (sprint_chain(error, sprint_list_int_complete(&list, parser->arena, &element->pad_tht.link.num_connections,
+                                                     &element->pad_tht.link.connections)) &&
                         !sprint_assert(false, sprint_pad_tht_valid(&element->pad_tht)))
         error = SPRINT_ERROR_ASSERTION;
 
@@ -751,6 +927,7 @@ static sprint_error sprint_parser_next_pad_smt_internal(sprint_parser* parser, s
     if (!sprint_chain(error, sprint_pad_smt_default(element, true)))
         return sprint_rethrow(error);
     element->parsed = true;
+    element->pooled = parser->arena != NULL;
 
     // Keep track of found properties
     bool found_layer = false, found_position = false, found_width = false, found_height = false, found_id = false,
@@ -758,9 +935,9 @@ static sprint_error sprint_parser_next_pad_smt_internal(sprint_parser* parser, s
             found_thermal_tracks = false, found_thermal_tracks_width = false, found_name = false;
 
     // Keep a list of connections
-    sprint_list* list = sprint_list_create(sizeof(*element->pad_smt.link.connections), 8);
-    if (list == NULL)
-        return SPRINT_ERROR_MEMORY;
+    sprint_list_int list = {0};
+    if (!sprint_chain(error, sprint_list_int_reserve(&list, 8)))
+        return sprint_rethrow(error);
 
     // Read all element properties
     sprint_statement statement;
@@ -772,78 +949,96 @@ static sprint_error sprint_parser_next_pad_smt_internal(sprint_parser* parser, s
             break;
         }
         if (!sprint_check(error)) {
-            sprint_check(sprint_list_destroy(list));
+            sprint_list_int_destroy(&list);
             return sprint_rethrow(error);
         }
 
         // Determine the statement name
         bool already_found = false;
-        if (strcasecmp(statement.name, "CON") == 0) {
-            int id = 0;
-            if (sprint_parser_statement_flags(&statement, true, SPRINT_STATEMENT_FLAG_INDEX) &&
-                sprint_parser_statement_index(&statement) == sprint_list_count(list) &&
-                sprint_chain(error, sprint_parser_next_uint(parser, &id)))
-                sprint_chain(error, sprint_list_add(list, &id));
-        } else if (sprint_parser_statement_flags(&statement, true, SPRINT_STATEMENT_FLAG_INDEX)) {
+        if (statement.keyword != SPRINT_KEYWORD_CON && sprint_parser_statement_flags(&statement, true, SPRINT_STATEMENT_FLAG_INDEX)) {
             error = SPRINT_ERROR_SYNTAX;
-            sprint_throw_format(false, "unexpected property index: %s%d", statement.name, statement.index);
-        } else if (strcasecmp(statement.name, "LAYER") == 0) {
-            if (found_layer)
-                already_found = true;
-            found_layer |= sprint_chain(error, sprint_parser_next_layer(parser, &element->pad_smt.layer));
-        } else if (strcasecmp(statement.name, "POS") == 0) {
-            if (found_position)
-                already_found = true;
-            found_position |= sprint_chain(error, sprint_parser_next_tuple(parser, &element->pad_smt.position));
-        } else if (strcasecmp(statement.name, "SIZE_X") == 0) {
-            if (found_width)
-                already_found = true;
-            found_width |= sprint_chain(error, sprint_parser_next_size(parser, &element->pad_smt.width));
-        } else if (strcasecmp(statement.name, "SIZE_Y") == 0) {
-            if (found_height)
-                already_found = true;
-            found_height |= sprint_chain(error, sprint_parser_next_size(parser, &element->pad_smt.height));
-        } else if (strcasecmp(statement.name, "PAD_ID") == 0) {
-            if (found_id)
-                already_found = true;
-            found_id |= sprint_chain(error, sprint_parser_next_uint(parser, &element->pad_smt.link.id));
-            element->pad_smt.link.has_id = found_id;
-        } else if (strcasecmp(statement.name, "CLEAR") == 0) {
-            if (found_clear)
-                already_found = true;
-            found_clear |= sprint_chain(error, sprint_parser_next_size(parser, &element->pad_smt.clear));
-        } else if (strcasecmp(statement.name, "SOLDERMASK") == 0) {
-            if (found_soldermask)
-                already_found = true;
-            found_soldermask |= sprint_chain(error, sprint_parser_next_bool(parser, &element->pad_smt.soldermask));
-        } else if (strcasecmp(statement.name, "ROTATION") == 0) {
-            if (found_rotation)
-                already_found = true;
-            found_rotation |= sprint_chain(error, sprint_parser_next_angle(parser, &element->pad_smt.rotation, SPRINT_PRIM_FORMAT_ANGLE_COARSE));
-        } else if (strcasecmp(statement.name, "THERMAL") == 0) {
-            if (found_thermal)
-                already_found = true;
-            found_thermal |= sprint_chain(error, sprint_parser_next_bool(parser, &element->pad_smt.thermal));
-        } else if (strcasecmp(statement.name, "THERMAL_TRACKS") == 0) {
-            if (found_thermal_tracks)
-                already_found = true;
-            found_thermal_tracks |= sprint_chain(error, sprint_parser_next_int(parser, &element->pad_smt.thermal_tracks));
-        } else if (strcasecmp(statement.name, "THERMAL_TRACKS_WIDTH") == 0) {
-            if (found_thermal_tracks_width)
-                already_found = true;
-            found_thermal_tracks_width |= sprint_chain(error, sprint_parser_next_uint(parser, &element->pad_smt.thermal_tracks_width));
-        } else if (strcasecmp(statement.name, "NAME") == 0) {
-            if (found_name)
-                already_found = true;
-            found_name |= sprint_chain(error, sprint_parser_next_str(parser, &element->pad_smt.name));
+            sprint_throw_format(false, "unexpected property index: %s%d", sprint_parser_statement_name(&statement), statement.index);
         } else {
-            error = SPRINT_ERROR_SYNTAX;
-            sprint_throw_format(false, "unknown property: %s", statement.name);
+            switch (statement.keyword) {
+                case SPRINT_KEYWORD_CON: {
+                    int id = 0;
+                    if (sprint_parser_statement_flags(&statement, true, SPRINT_STATEMENT_FLAG_INDEX) &&
+                        sprint_parser_statement_index(&statement) == list.count &&
+                        sprint_chain(error, sprint_parser_next_uint(parser, &id)))
+                        sprint_chain(error, sprint_list_int_add(&list, id));
+                    break;
+                }
+                case SPRINT_KEYWORD_LAYER:
+                    if (found_layer)
+                        already_found = true;
+                    found_layer |= sprint_chain(error, sprint_parser_next_layer(parser, &element->pad_smt.layer));
+                    break;
+                case SPRINT_KEYWORD_POS:
+                    if (found_position)
+                        already_found = true;
+                    found_position |= sprint_chain(error, sprint_parser_next_tuple(parser, &element->pad_smt.position));
+                    break;
+                case SPRINT_KEYWORD_SIZE_X:
+                    if (found_width)
+                        already_found = true;
+                    found_width |= sprint_chain(error, sprint_parser_next_size(parser, &element->pad_smt.width));
+                    break;
+                case SPRINT_KEYWORD_SIZE_Y:
+                    if (found_height)
+                        already_found = true;
+                    found_height |= sprint_chain(error, sprint_parser_next_size(parser, &element->pad_smt.height));
+                    break;
+                case SPRINT_KEYWORD_PAD_ID:
+                    if (found_id)
+                        already_found = true;
+                    found_id |= sprint_chain(error, sprint_parser_next_uint(parser, &element->pad_smt.link.id));
+                    element->pad_smt.link.has_id = found_id;
+                    break;
+                case SPRINT_KEYWORD_CLEAR:
+                    if (found_clear)
+                        already_found = true;
+                    found_clear |= sprint_chain(error, sprint_parser_next_size(parser, &element->pad_smt.clear));
+                    break;
+                case SPRINT_KEYWORD_SOLDERMASK:
+                    if (found_soldermask)
+                        already_found = true;
+                    found_soldermask |= sprint_chain(error, sprint_parser_next_bool(parser, &element->pad_smt.soldermask));
+                    break;
+                case SPRINT_KEYWORD_ROTATION:
+                    if (found_rotation)
+                        already_found = true;
+                    found_rotation |= sprint_chain(error, sprint_parser_next_angle(parser, &element->pad_smt.rotation, SPRINT_PRIM_FORMAT_ANGLE_COARSE));
+                    break;
+                case SPRINT_KEYWORD_THERMAL:
+                    if (found_thermal)
+                        already_found = true;
+                    found_thermal |= sprint_chain(error, sprint_parser_next_bool(parser, &element->pad_smt.thermal));
+                    break;
+                case SPRINT_KEYWORD_THERMAL_TRACKS:
+                    if (found_thermal_tracks)
+                        already_found = true;
+                    found_thermal_tracks |= sprint_chain(error, sprint_parser_next_int(parser, &element->pad_smt.thermal_tracks));
+                    break;
+                case SPRINT_KEYWORD_THERMAL_TRACKS_WIDTH:
+                    if (found_thermal_tracks_width)
+                        already_found = true;
+                    found_thermal_tracks_width |= sprint_chain(error, sprint_parser_next_uint(parser, &element->pad_smt.thermal_tracks_width));
+                    break;
+                case SPRINT_KEYWORD_NAME:
+                    if (found_name)
+                        already_found = true;
+                    found_name |= sprint_chain(error, sprint_parser_next_str(parser, &element->pad_smt.name));
+                    break;
+                default:
+                    error = SPRINT_ERROR_SYNTAX;
+                    sprint_throw_format(false, "unknown property: %s", sprint_parser_statement_name(&statement));
+                    break;
+            }
         }
 
         // Handle already found properties
         if (already_found)
-            sprint_warning_format("overwriting duplicate property: %s", statement.name);
+            sprint_warning_format("overwriting duplicate property: %s", sprint_parser_statement_name(&statement));
 
         // Destroy the statement
         sprint_check(sprint_parser_statement_destroy(&statement));
@@ -857,11 +1052,17 @@ static sprint_error sprint_parser_next_pad_smt_internal(sprint_parser* parser, s
 
         // All other errors stop processing
         if (error != SPRINT_ERROR_NONE) {
-            sprint_check(sprint_list_destroy(list));
+            sprint_list_int_destroy(&list);
             return sprint_rethrow(error);
         }
     }
 
+    // Discard the element, if it is on a layer that is filtered out
+    if (parser->filtered) {
+        sprint_list_int_destroy(&list);
+        return SPRINT_ERROR_NONE;
+    }
+
     // Make sure that there are all properties
     if (!found_layer | !found_position | !found_width | !found_height | (element->pad_smt.thermal & (!found_thermal_tracks | !found_thermal_tracks_width))) {
         sprint_throw_format(false, "incomplete element: %s", sprint_element_type_to_keyword(SPRINT_ELEMENT_PAD_SMT, false));
@@ -869,8 +1070,8 @@ static sprint_error sprint_parser_next_pad_smt_internal(sprint_parser* parser, s
     }
 
     // Complete the list and check verify full validity
-    if (sprint_chain(error, sprint_list_complete(list, &element->pad_smt.link.num_connections,
-                                                 (void*) &element->pad_smt.link.connections)) &&
+    if (sprint_chain(error, sprint_list_int_complete(&list, parser->arena, &element->pad_smt.link.num_connections,
+                                                     &element->pad_smt.link.connections)) &&
         !sprint_assert(false, sprint_pad_smt_valid(&element->pad_smt)))
         error = SPRINT_ERROR_ASSERTION;
 
@@ -884,15 +1085,16 @@ static sprint_error sprint_parser_next_zone_internal(sprint_parser* parser, spri
     if (!sprint_chain(error, sprint_zone_default(element, true)))
         return sprint_rethrow(error);
     element->parsed = true;
+    element->pooled = parser->arena != NULL;
 
     // Keep track of found properties
     bool found_layer = false, found_width = false, found_clear = false, found_cutout = false, found_soldermask = false,
             found_soldermask_cutout = false, found_hatch = false, found_hatch_auto = false, found_hatch_width = false, found_name = false;
 
     // Keep a list of points
-    sprint_list* list = sprint_list_create(sizeof(*element->zone.points), 16);
-    if (list == NULL)
-        return SPRINT_ERROR_MEMORY;
+    sprint_list_tuple list = {0};
+    if (!sprint_chain(error, sprint_list_tuple_reserve(&list, 16)))
+        return sprint_rethrow(error);
 
     // Read all element properties
     sprint_statement statement;
@@ -904,69 +1106,85 @@ static sprint_error sprint_parser_next_zone_internal(sprint_parser* parser, spri
             break;
         }
         if (!sprint_check(error)) {
-            sprint_check(sprint_list_destroy(list));
+            sprint_list_tuple_destroy(&list);
             return sprint_rethrow(error);
         }
 
         // Determine the statement name
         bool already_found = false;
-        if (strcasecmp(statement.name, "P") == 0) {
-            sprint_tuple tuple;
-            if (sprint_parser_statement_flags(&statement, true, SPRINT_STATEMENT_FLAG_INDEX) &&
-                sprint_parser_statement_index(&statement) == sprint_list_count(list) &&
-                sprint_chain(error, sprint_parser_next_tuple(parser, &tuple)))
-                sprint_chain(error, sprint_list_add(list, &tuple));
-        } else if (sprint_parser_statement_flags(&statement, true, SPRINT_STATEMENT_FLAG_INDEX)) {
+        if (statement.keyword != SPRINT_KEYWORD_P && sprint_parser_statement_flags(&statement, true, SPRINT_STATEMENT_FLAG_INDEX)) {
             error = SPRINT_ERROR_SYNTAX;
-            sprint_throw_format(false, "unexpected property index: %s%d", statement.name, statement.index);
-        } else if (strcasecmp(statement.name, "LAYER") == 0) {
-            if (found_layer)
-                already_found = true;
-            found_layer |= sprint_chain(error, sprint_parser_next_layer(parser, &element->zone.layer));
-        } else if (strcasecmp(statement.name, "WIDTH") == 0) {
-            if (found_width)
-                already_found = true;
-            found_width |= sprint_chain(error, sprint_parser_next_size(parser, &element->zone.width));
-        } else if (strcasecmp(statement.name, "CLEAR") == 0) {
-            if (found_clear)
-                already_found = true;
-            found_clear |= sprint_chain(error, sprint_parser_next_size(parser, &element->zone.clear));
-        } else if (strcasecmp(statement.name, "CUTOUT") == 0) {
-            if (found_cutout)
-                already_found = true;
-            found_cutout |= sprint_chain(error, sprint_parser_next_bool(parser, &element->zone.cutout));
-        } else if (strcasecmp(statement.name, "SOLDERMASK") == 0) {
-            if (found_soldermask)
-                already_found = true;
-            found_soldermask |= sprint_chain(error, sprint_parser_next_bool(parser, &element->zone.soldermask));
-        } else if (strcasecmp(statement.name, "SOLDERMASK_CUTOUT") == 0) {
-            if (found_soldermask_cutout)
-                already_found = true;
-            found_soldermask_cutout |= sprint_chain(error, sprint_parser_next_bool(parser, &element->zone.soldermask_cutout));
-        } else if (strcasecmp(statement.name, "HATCH") == 0) {
-            if (found_hatch)
-                already_found = true;
-            found_hatch |= sprint_chain(error, sprint_parser_next_bool(parser, &element->zone.hatch));
-        } else if (strcasecmp(statement.name, "HATCH_AUTO") == 0) {
-            if (found_hatch_auto)
-                already_found = true;
-            found_hatch_auto |= sprint_chain(error, sprint_parser_next_bool(parser, &element->zone.hatch_auto));
-        } else if (strcasecmp(statement.name, "HATCH_WIDTH") == 0) {
-            if (found_hatch_width)
-                already_found = true;
-            found_hatch_width |= sprint_chain(error, sprint_parser_next_size(parser, &element->zone.hatch_width));
-        } else if (strcasecmp(statement.name, "NAME") == 0) {
-            if (found_name)
-                already_found = true;
-            found_name |= sprint_chain(error, sprint_parser_next_str(parser, &element->zone.name));
+            sprint_throw_format(false, "unexpected property index: %s%d", sprint_parser_statement_name(&statement), statement.index);
         } else {
-            error = SPRINT_ERROR_SYNTAX;
-            sprint_throw_format(false, "unknown property: %s", statement.name);
+            switch (statement.keyword) {
+                case SPRINT_KEYWORD_P: {
+                    sprint_tuple tuple;
+                    if (sprint_parser_statement_flags(&statement, true, SPRINT_STATEMENT_FLAG_INDEX) &&
+                        sprint_parser_statement_index(&statement) == list.count &&
+                        sprint_chain(error, sprint_parser_next_tuple(parser, &tuple)))
+                        sprint_chain(error, sprint_list_tuple_add(&list, tuple));
+                    break;
+                }
+                case SPRINT_KEYWORD_LAYER:
+                    if (found_layer)
+                        already_found = true;
+                    found_layer |= sprint_chain(error, sprint_parser_next_layer(parser, &element->zone.layer));
+                    break;
+                case SPRINT_KEYWORD_WIDTH:
+                    if (found_width)
+                        already_found = true;
+                    found_width |= sprint_chain(error, sprint_parser_next_size(parser, &element->zone.width));
+                    break;
+                case SPRINT_KEYWORD_CLEAR:
+                    if (found_clear)
+                        already_found = true;
+                    found_clear |= sprint_chain(error, sprint_parser_next_size(parser, &element->zone.clear));
+                    break;
+                case SPRINT_KEYWORD_CUTOUT:
+                    if (found_cutout)
+                        already_found = true;
+                    found_cutout |= sprint_chain(error, sprint_parser_next_bool(parser, &element->zone.cutout));
+                    break;
+                case SPRINT_KEYWORD_SOLDERMASK:
+                    if (found_soldermask)
+                        already_found = true;
+                    found_soldermask |= sprint_chain(error, sprint_parser_next_bool(parser, &element->zone.soldermask));
+                    break;
+                case SPRINT_KEYWORD_SOLDERMASK_CUTOUT:
+                    if (found_soldermask_cutout)
+                        already_found = true;
+                    found_soldermask_cutout |= sprint_chain(error, sprint_parser_next_bool(parser, &element->zone.soldermask_cutout));
+                    break;
+                case SPRINT_KEYWORD_HATCH:
+                    if (found_hatch)
+                        already_found = true;
+                    found_hatch |= sprint_chain(error, sprint_parser_next_bool(parser, &element->zone.hatch));
+                    break;
+                case SPRINT_KEYWORD_HATCH_AUTO:
+                    if (found_hatch_auto)
+                        already_found = true;
+                    found_hatch_auto |= sprint_chain(error, sprint_parser_next_bool(parser, &element->zone.hatch_auto));
+                    break;
+                case SPRINT_KEYWORD_HATCH_WIDTH:
+                    if (found_hatch_width)
+                        already_found = true;
+                    found_hatch_width |= sprint_chain(error, sprint_parser_next_size(parser, &element->zone.hatch_width));
+                    break;
+                case SPRINT_KEYWORD_NAME:
+                    if (found_name)
+                        already_found = true;
+                    found_name |= sprint_chain(error, sprint_parser_next_str(parser, &element->zone.name));
+                    break;
+                default:
+                    error = SPRINT_ERROR_SYNTAX;
+                    sprint_throw_format(false, "unknown property: %s", sprint_parser_statement_name(&statement));
+                    break;
+            }
         }
 
         // Handle already found properties
         if (already_found)
-            sprint_warning_format("overwriting duplicate property: %s", statement.name);
+            sprint_warning_format("overwriting duplicate property: %s", sprint_parser_statement_name(&statement));
 
         // Destroy the statement
         sprint_check(sprint_parser_statement_destroy(&statement));
@@ -980,19 +1198,25 @@ static sprint_error sprint_parser_next_zone_internal(sprint_parser* parser, spri
 
         // All other errors stop processing
         if (error != SPRINT_ERROR_NONE) {
-            sprint_check(sprint_list_destroy(list));
+            sprint_list_tuple_destroy(&list);
             return sprint_rethrow(error);
         }
     }
 
+    // Discard the element, if it is on a layer that is filtered out
+    if (parser->filtered) {
+        sprint_list_tuple_destroy(&list);
+        return SPRINT_ERROR_NONE;
+    }
+
     // Make sure that there are at least two points and all properties
-    if (!found_layer | !found_width | sprint_list_count(list) < 2 | element->zone.hatch & !element->zone.hatch_auto & !found_hatch_width) {
+    if (!found_layer | !found_width | list.count < 2 | element->zone.hatch & !element->zone.hatch_auto & !found_hatch_width) {
         sprint_throw_format(false, "incomplete element: %s", sprint_element_type_to_keyword(SPRINT_ELEMENT_ZONE, false));
         error = SPRINT_ERROR_SYNTAX;
     }
 
     // Complete the list and check verify full validity
-    if (sprint_chain(error, sprint_list_complete(list, &element->zone.num_points, (void*) &element->zone.points)) &&
+    if (sprint_chain(error, sprint_list_tuple_complete(&list, parser->arena, &element->zone.num_points, &element->zone.points)) &&
         !sprint_assert(false, sprint_zone_valid(&element->zone)))
         error = SPRINT_ERROR_ASSERTION;
 
@@ -1006,6 +1230,7 @@ static sprint_error sprint_parser_next_text_internal(sprint_parser* parser, spri
     if (!sprint_chain(error, sprint_text_default(element, true)))
         return sprint_rethrow(error);
     element->parsed = true;
+    element->pooled = parser->arena != NULL;
 
     // Keep track of found properties
     bool found_layer = false, found_position = false, found_height = false, found_text = false, found_clear = false,
@@ -1029,71 +1254,89 @@ static sprint_error sprint_parser_next_text_internal(sprint_parser* parser, spri
         bool already_found = false;
         if (sprint_parser_statement_flags(&statement, true, SPRINT_STATEMENT_FLAG_INDEX)) {
             error = SPRINT_ERROR_SYNTAX;
-            sprint_throw_format(false, "unexpected property index: %s%d", statement.name, statement.index);
-        } else if (strcasecmp(statement.name, "LAYER") == 0) {
-            if (found_layer)
-                already_found = true;
-            found_layer |= sprint_chain(error, sprint_parser_next_layer(parser, &element->text.layer));
-        } else if (strcasecmp(statement.name, "POS") == 0) {
-            if (found_position)
-                already_found = true;
-            found_position |= sprint_chain(error, sprint_parser_next_tuple(parser, &element->text.position));
-        } else if (strcasecmp(statement.name, "HEIGHT") == 0) {
-            if (found_height)
-                already_found = true;
-            found_height |= sprint_chain(error, sprint_parser_next_size(parser, &element->text.height));
-        } else if (strcasecmp(statement.name, "TEXT") == 0) {
-            if (found_text)
-                already_found = true;
-            found_text |= sprint_chain(error, sprint_parser_next_str(parser, &element->text.text));
-        } else if (strcasecmp(statement.name, "CLEAR") == 0) {
-            if (found_clear)
-                already_found = true;
-            found_clear |= sprint_chain(error, sprint_parser_next_size(parser, &element->text.clear));
-        } else if (strcasecmp(statement.name, "CUTOUT") == 0) {
-            if (found_cutout)
-                already_found = true;
-            found_cutout |= sprint_chain(error, sprint_parser_next_bool(parser, &element->text.cutout));
-        } else if (strcasecmp(statement.name, "SOLDERMASK") == 0) {
-            if (found_soldermask)
-                already_found = true;
-            found_soldermask |= sprint_chain(error, sprint_parser_next_bool(parser, &element->text.soldermask));
-        } else if (strcasecmp(statement.name, "STYLE") == 0) {
-            if (found_style)
-                already_found = true;
-            found_style |= sprint_chain(error, sprint_parser_next_text_style(parser, &element->text.style));
-        } else if (strcasecmp(statement.name, "THICKNESS") == 0) {
-            if (found_thickness)
-                already_found = true;
-            found_thickness |= sprint_chain(error, sprint_parser_next_text_thickness(parser, &element->text.thickness));
-        } else if (strcasecmp(statement.name, "FLATEND") == 0) {
-            if (found_rotation)
-                already_found = true;
-            found_rotation |= sprint_chain(error, sprint_parser_next_angle(parser, &element->text.rotation, SPRINT_PRIM_FORMAT_ANGLE_WHOLE));
-        } else if (strcasecmp(statement.name, "MIRROR_HORZ") == 0) {
-            if (found_mirror_horizontal)
-                already_found = true;
-            found_mirror_horizontal |= sprint_chain(error, sprint_parser_next_bool(parser, &element->text.mirror_horizontal));
-        } else if (strcasecmp(statement.name, "MIRROR_VERT") == 0) {
-            if (found_mirror_vertical)
-                already_found = true;
-            found_mirror_vertical |= sprint_chain(error, sprint_parser_next_bool(parser, &element->text.mirror_vertical));
-        } else if (strcasecmp(statement.name, "NAME") == 0) {
-            if (found_name)
-                already_found = true;
-            found_name |= sprint_chain(error, sprint_parser_next_str(parser, &element->text.name));
-        } else if (strcasecmp(statement.name, "VISIBLE") == 0) {
-            if (found_visible)
-                already_found = true;
-            found_visible |= sprint_chain(error, sprint_parser_next_bool(parser, &element->text.visible));
+            sprint_throw_format(false, "unexpected property index: %s%d", sprint_parser_statement_name(&statement), statement.index);
         } else {
-            error = SPRINT_ERROR_SYNTAX;
-            sprint_throw_format(false, "unknown property: %s", statement.name);
+            switch (statement.keyword) {
+                case SPRINT_KEYWORD_LAYER:
+                    if (found_layer)
+                        already_found = true;
+                    found_layer |= sprint_chain(error, sprint_parser_next_layer(parser, &element->text.layer));
+                    break;
+                case SPRINT_KEYWORD_POS:
+                    if (found_position)
+                        already_found = true;
+                    found_position |= sprint_chain(error, sprint_parser_next_tuple(parser, &element->text.position));
+                    break;
+                case SPRINT_KEYWORD_HEIGHT:
+                    if (found_height)
+                        already_found = true;
+                    found_height |= sprint_chain(error, sprint_parser_next_size(parser, &element->text.height));
+                    break;
+                case SPRINT_KEYWORD_TEXT:
+                    if (found_text)
+                        already_found = true;
+                    found_text |= sprint_chain(error, sprint_parser_next_str(parser, &element->text.text));
+                    break;
+                case SPRINT_KEYWORD_CLEAR:
+                    if (found_clear)
+                        already_found = true;
+                    found_clear |= sprint_chain(error, sprint_parser_next_size(parser, &element->text.clear));
+                    break;
+                case SPRINT_KEYWORD_CUTOUT:
+                    if (found_cutout)
+                        already_found = true;
+                    found_cutout |= sprint_chain(error, sprint_parser_next_bool(parser, &element->text.cutout));
+                    break;
+                case SPRINT_KEYWORD_SOLDERMASK:
+                    if (found_soldermask)
+                        already_found = true;
+                    found_soldermask |= sprint_chain(error, sprint_parser_next_bool(parser, &element->text.soldermask));
+                    break;
+                case SPRINT_KEYWORD_STYLE:
+                    if (found_style)
+                        already_found = true;
+                    found_style |= sprint_chain(error, sprint_parser_next_text_style(parser, &element->text.style));
+                    break;
+                case SPRINT_KEYWORD_THICKNESS:
+                    if (found_thickness)
+                        already_found = true;
+                    found_thickness |= sprint_chain(error, sprint_parser_next_text_thickness(parser, &element->text.thickness));
+                    break;
+                case SPRINT_KEYWORD_FLATEND:
+                    if (found_rotation)
+                        already_found = true;
+                    found_rotation |= sprint_chain(error, sprint_parser_next_angle(parser, &element->text.rotation, SPRINT_PRIM_FORMAT_ANGLE_WHOLE));
+                    break;
+                case SPRINT_KEYWORD_MIRROR_HORZ:
+                    if (found_mirror_horizontal)
+                        already_found = true;
+                    found_mirror_horizontal |= sprint_chain(error, sprint_parser_next_bool(parser, &element->text.mirror_horizontal));
+                    break;
+                case SPRINT_KEYWORD_MIRROR_VERT:
+                    if (found_mirror_vertical)
+                        already_found = true;
+                    found_mirror_vertical |= sprint_chain(error, sprint_parser_next_bool(parser, &element->text.mirror_vertical));
+                    break;
+                case SPRINT_KEYWORD_NAME:
+                    if (found_name)
+                        already_found = true;
+                    found_name |= sprint_chain(error, sprint_parser_next_str(parser, &element->text.name));
+                    break;
+                case SPRINT_KEYWORD_VISIBLE:
+                    if (found_visible)
+                        already_found = true;
+                    found_visible |= sprint_chain(error, sprint_parser_next_bool(parser, &element->text.visible));
+                    break;
+                default:
+                    error = SPRINT_ERROR_SYNTAX;
+                    sprint_throw_format(false, "unknown property: %s", sprint_parser_statement_name(&statement));
+                    break;
+            }
         }
 
         // Handle already found properties
         if (already_found)
-            sprint_warning_format("overwriting duplicate property: %s", statement.name);
+            sprint_warning_format("overwriting duplicate property: %s", sprint_parser_statement_name(&statement));
 
         // Destroy the statement
         sprint_check(sprint_parser_statement_destroy(&statement));
@@ -1110,6 +1353,10 @@ static sprint_error sprint_parser_next_text_internal(sprint_parser* parser, spri
             return sprint_rethrow(error);
     }
 
+    // Discard the element, if it is on a layer that is filtered out
+    if (parser->filtered)
+        return SPRINT_ERROR_NONE;
+
     // Make sure that there are all properties
     if (!found_layer | !found_position | !found_height | !found_text) {
         sprint_throw_format(false, "incomplete element: %s", sprint_element_type_to_keyword(SPRINT_ELEMENT_TEXT, false));
@@ -1130,6 +1377,7 @@ static sprint_error sprint_parser_next_circle_internal(sprint_parser* parser, sp
     if (!sprint_chain(error, sprint_circle_default(element, true)))
         return sprint_rethrow(error);
     element->parsed = true;
+    element->pooled = parser->arena != NULL;
 
     // Keep track of found properties
     bool found_layer = false, found_width = false, found_center = false, found_radius = false, found_clear = false,
@@ -1152,59 +1400,74 @@ static sprint_error sprint_parser_next_circle_internal(sprint_parser* parser, sp
         bool already_found = false;
         if (sprint_parser_statement_flags(&statement, true, SPRINT_STATEMENT_FLAG_INDEX)) {
             error = SPRINT_ERROR_SYNTAX;
-            sprint_throw_format(false, "unexpected property index: %s%d", statement.name, statement.index);
-        } else if (strcasecmp(statement.name, "LAYER") == 0) {
-            if (found_layer)
-                already_found = true;
-            found_layer |= sprint_chain(error, sprint_parser_next_layer(parser, &element->circle.layer));
-        } else if (strcasecmp(statement.name, "WIDTH") == 0) {
-            if (found_width)
-                already_found = true;
-            found_width |= sprint_chain(error, sprint_parser_next_size(parser, &element->circle.width));
-        } else if (strcasecmp(statement.name, "CENTER") == 0) {
-            if (found_center)
-                already_found = true;
-            found_center |= sprint_chain(error, sprint_parser_next_tuple(parser, &element->circle.center));
-        } else if (strcasecmp(statement.name, "RADIUS") == 0) {
-            if (found_radius)
-                already_found = true;
-            found_radius |= sprint_chain(error, sprint_parser_next_size(parser, &element->circle.radius));
-        } else if (strcasecmp(statement.name, "CLEAR") == 0) {
-            if (found_clear)
-                already_found = true;
-            found_clear |= sprint_chain(error, sprint_parser_next_size(parser, &element->circle.clear));
-        } else if (strcasecmp(statement.name, "CUTOUT") == 0) {
-            if (found_cutout)
-                already_found = true;
-            found_cutout |= sprint_chain(error, sprint_parser_next_bool(parser, &element->circle.cutout));
-        } else if (strcasecmp(statement.name, "SOLDERMASK") == 0) {
-            if (found_soldermask)
-                already_found = true;
-            found_soldermask |= sprint_chain(error, sprint_parser_next_bool(parser, &element->circle.soldermask));
-        } else if (strcasecmp(statement.name, "START") == 0) {
-            if (found_start)
-                already_found = true;
-            found_start |= sprint_chain(error, sprint_parser_next_angle(parser, &element->circle.start, SPRINT_PRIM_FORMAT_ANGLE_FINE));
-        } else if (strcasecmp(statement.name, "STOP") == 0) {
-            if (found_stop)
-                already_found = true;
-            found_stop |= sprint_chain(error, sprint_parser_next_angle(parser, &element->circle.stop, SPRINT_PRIM_FORMAT_ANGLE_FINE));
-        } else if (strcasecmp(statement.name, "FILL") == 0) {
-            if (found_fill)
-                already_found = true;
-            found_fill |= sprint_chain(error, sprint_parser_next_bool(parser, &element->circle.fill));
-        } else if (strcasecmp(statement.name, "NAME") == 0) {
-            if (found_name)
-                already_found = true;
-            found_name |= sprint_chain(error, sprint_parser_next_str(parser, &element->circle.name));
+            sprint_throw_format(false, "unexpected property index: %s%d", sprint_parser_statement_name(&statement), statement.index);
         } else {
-            error = SPRINT_ERROR_SYNTAX;
-            sprint_throw_format(false, "unknown property: %s", statement.name);
+            switch (statement.keyword) {
+                case SPRINT_KEYWORD_LAYER:
+                    if (found_layer)
+                        already_found = true;
+                    found_layer |= sprint_chain(error, sprint_parser_next_layer(parser, &element->circle.layer));
+                    break;
+                case SPRINT_KEYWORD_WIDTH:
+                    if (found_width)
+                        already_found = true;
+                    found_width |= sprint_chain(error, sprint_parser_next_size(parser, &element->circle.width));
+                    break;
+                case SPRINT_KEYWORD_CENTER:
+                    if (found_center)
+                        already_found = true;
+                    found_center |= sprint_chain(error, sprint_parser_next_tuple(parser, &element->circle.center));
+                    break;
+                case SPRINT_KEYWORD_RADIUS:
+                    if (found_radius)
+                        already_found = true;
+                    found_radius |= sprint_chain(error, sprint_parser_next_size(parser, &element->circle.radius));
+                    break;
+                case SPRINT_KEYWORD_CLEAR:
+                    if (found_clear)
+                        already_found = true;
+                    found_clear |= sprint_chain(error, sprint_parser_next_size(parser, &element->circle.clear));
+                    break;
+                case SPRINT_KEYWORD_CUTOUT:
+                    if (found_cutout)
+                        already_found = true;
+                    found_cutout |= sprint_chain(error, sprint_parser_next_bool(parser, &element->circle.cutout));
+                    break;
+                case SPRINT_KEYWORD_SOLDERMASK:
+                    if (found_soldermask)
+                        already_found = true;
+                    found_soldermask |= sprint_chain(error, sprint_parser_next_bool(parser, &element->circle.soldermask));
+                    break;
+                case SPRINT_KEYWORD_START:
+                    if (found_start)
+                        already_found = true;
+                    found_start |= sprint_chain(error, sprint_parser_next_angle(parser, &element->circle.start, SPRINT_PRIM_FORMAT_ANGLE_FINE));
+                    break;
+                case SPRINT_KEYWORD_STOP:
+                    if (found_stop)
+                        already_found = true;
+                    found_stop |= sprint_chain(error, sprint_parser_next_angle(parser, &element->circle.stop, SPRINT_PRIM_FORMAT_ANGLE_FINE));
+                    break;
+                case SPRINT_KEYWORD_FILL:
+                    if (found_fill)
+                        already_found = true;
+                    found_fill |= sprint_chain(error, sprint_parser_next_bool(parser, &element->circle.fill));
+                    break;
+                case SPRINT_KEYWORD_NAME:
+                    if (found_name)
+                        already_found = true;
+                    found_name |= sprint_chain(error, sprint_parser_next_str(parser, &element->circle.name));
+                    break;
+                default:
+                    error = SPRINT_ERROR_SYNTAX;
+                    sprint_throw_format(false, "unknown property: %s", sprint_parser_statement_name(&statement));
+                    break;
+            }
         }
 
         // Handle already found properties
         if (already_found)
-            sprint_warning_format("overwriting duplicate property: %s", statement.name);
+            sprint_warning_format("overwriting duplicate property: %s", sprint_parser_statement_name(&statement));
 
         // Destroy the statement
         sprint_check(sprint_parser_statement_destroy(&statement));
@@ -1221,6 +1484,10 @@ static sprint_error sprint_parser_next_circle_internal(sprint_parser* parser, sp
             return sprint_rethrow(error);
     }
 
+    // Discard the element, if it is on a layer that is filtered out
+    if (parser->filtered)
+        return SPRINT_ERROR_NONE;
+
     // Make sure that there are all properties
     if (!found_layer | !found_width | !found_center | !found_radius) {
         sprint_throw_format(false, "incomplete element: %s", sprint_element_type_to_keyword(SPRINT_ELEMENT_CIRCLE, false));
@@ -1234,10 +1501,29 @@ static sprint_error sprint_parser_next_circle_internal(sprint_parser* parser, sp
     return sprint_rethrow(error);
 }
 
+static bool sprint_parser_excluded_internal(sprint_parser* parser, sprint_element_type type)
+{
+    return parser->filter.types != 0 && (parser->filter.types & 1 << type) == 0;
+}
+
+static bool sprint_parser_rejected_internal(sprint_parser* parser, sprint_element* element, sprint_error error)
+{
+    // Reset the layer filter for the next element
+    bool filtered = parser->filtered;
+    parser->layers = 0;
+    parser->filtered = false;
+
+    // Reject read elements that are on a filtered layer or that the predicate does not accept
+    if (error != SPRINT_ERROR_NONE)
+        return false;
+    return filtered || (parser->filter.predicate != NULL && !parser->filter.predicate(element, parser->filter.user));
+}
+
 #pragma clang diagnostic push
 #pragma ide diagnostic ignored "misc-no-recursion"
-static sprint_error sprint_parser_next_element_internal(sprint_parser* parser, sprint_element** element,
+static sprint_error sprint_parser_next_element_internal(sprint_parser* parser, sprint_element* element,
                                                         bool* salvaged, sprint_element_type parent, int depth);
+static sprint_element* sprint_parser_element_alloc_internal(sprint_parser* parser);
 
 static sprint_error sprint_parser_next_component_internal(sprint_parser* parser, sprint_element* element,
                                                           bool* salvaged, int depth)
@@ -1247,6 +1533,7 @@ static sprint_error sprint_parser_next_component_internal(sprint_parser* parser,
     if (!sprint_chain(error, sprint_component_default(element, true)))
         return sprint_rethrow(error);
     element->parsed = true;
+    element->pooled = parser->arena != NULL;
 
     // Keep track of found properties
     bool found_comment = false, found_use_pickplace = false, found_package = false, found_rotation = false;
@@ -1267,31 +1554,39 @@ static sprint_error sprint_parser_next_component_internal(sprint_parser* parser,
         bool already_found = false;
         if (sprint_parser_statement_flags(&statement, true, SPRINT_STATEMENT_FLAG_INDEX)) {
             error = SPRINT_ERROR_SYNTAX;
-            sprint_throw_format(false, "unexpected property index: %s%d", statement.name, statement.index);
-        } else if (strcasecmp(statement.name, "COMMENT") == 0) {
-            if (found_comment)
-                already_found = true;
-            found_comment |= sprint_chain(error, sprint_parser_next_str(parser, &element->component.comment));
-        } else if (strcasecmp(statement.name, "USE_PICKPLACE") == 0) {
-            if (found_use_pickplace)
-                already_found = true;
-            found_use_pickplace |= sprint_chain(error, sprint_parser_next_bool(parser, &element->component.use_pickplace));
-        } else if (strcasecmp(statement.name, "PACKAGE") == 0) {
-            if (found_package)
-                already_found = true;
-            found_package |= sprint_chain(error, sprint_parser_next_str(parser, &element->component.package));
-        } else if (strcasecmp(statement.name, "ROTATION") == 0) {
-            if (found_rotation)
-                already_found = true;
-            found_rotation |= sprint_chain(error, sprint_parser_next_angle(parser, &element->component.rotation, SPRINT_PRIM_FORMAT_ANGLE_WHOLE));
+            sprint_throw_format(false, "unexpected property index: %s%d", sprint_parser_statement_name(&statement), statement.index);
         } else {
-            error = SPRINT_ERROR_SYNTAX;
-            sprint_throw_format(false, "unknown property: %s", statement.name);
+            switch (statement.keyword) {
+                case SPRINT_KEYWORD_COMMENT:
+                    if (found_comment)
+                        already_found = true;
+                    found_comment |= sprint_chain(error, sprint_parser_next_str(parser, &element->component.comment));
+                    break;
+                case SPRINT_KEYWORD_USE_PICKPLACE:
+                    if (found_use_pickplace)
+                        already_found = true;
+                    found_use_pickplace |= sprint_chain(error, sprint_parser_next_bool(parser, &element->component.use_pickplace));
+                    break;
+                case SPRINT_KEYWORD_PACKAGE:
+                    if (found_package)
+                        already_found = true;
+                    found_package |= sprint_chain(error, sprint_parser_next_str(parser, &element->component.package));
+                    break;
+                case SPRINT_KEYWORD_ROTATION:
+                    if (found_rotation)
+                        already_found = true;
+                    found_rotation |= sprint_chain(error, sprint_parser_next_angle(parser, &element->component.rotation, SPRINT_PRIM_FORMAT_ANGLE_WHOLE));
+                    break;
+                default:
+                    error = SPRINT_ERROR_SYNTAX;
+                    sprint_throw_format(false, "unknown property: %s", sprint_parser_statement_name(&statement));
+                    break;
+            }
         }
 
         // Handle already found properties
         if (already_found)
-            sprint_warning_format("overwriting duplicate property: %s", statement.name);
+            sprint_warning_format("overwriting duplicate property: %s", sprint_parser_statement_name(&statement));
 
         // Destroy the statement
         sprint_check(sprint_parser_statement_destroy(&statement));
@@ -1310,57 +1605,67 @@ static sprint_error sprint_parser_next_component_internal(sprint_parser* parser,
 
     // Read the elements
     bool found_text_id = false, found_text_value = false;
-    sprint_list* list = sprint_list_create(sizeof(sprint_element), 16);
-    if (list == NULL)
-        return SPRINT_ERROR_MEMORY;
+    sprint_list_element list = {0};
+    if (!sprint_chain(error, sprint_list_element_reserve(&list, 16)))
+        return sprint_rethrow(error);
     sprint_element* child = NULL;
     bool child_salvaged = false;
     while (true) {
-        // Read the next element
-        error = sprint_parser_next_element_internal(parser, &child, &child_salvaged, SPRINT_ELEMENT_COMPONENT, depth + 1);
-        if (error == SPRINT_ERROR_EOE || !sprint_check(error))
+        // Read the next element directly into a new slot at the end of the list
+        if (!sprint_chain(error, sprint_list_element_push(&list, &child)))
             break;
+        error = sprint_parser_next_element_internal(parser, child, &child_salvaged, SPRINT_ELEMENT_COMPONENT, depth + 1);
+        *salvaged |= child_salvaged;
+        if (error == SPRINT_ERROR_EOE || !sprint_check(error)) {
+            sprint_list_element_remove(&list);
+            break;
+        }
 
         // Check, if the element is an ID or value text
         if (child->type == SPRINT_ELEMENT_TEXT) {
-            bool special_text_found = true, already_found = false;
+            sprint_element** special_text = NULL;
+            bool already_found = false;
             sprint_text_type subtype = child->text.subtype;
             switch (subtype) {
                 case SPRINT_TEXT_ID:
                     if (found_text_id)
                         already_found = true;
                     found_text_id = true;
-                    element->component.text_id = child;
+                    special_text = &element->component.text_id;
                     break;
                 case SPRINT_TEXT_VALUE:
                     if (found_text_value)
                         already_found = true;
                     found_text_value = true;
-                    element->component.text_value = child;
+                    special_text = &element->component.text_value;
                     break;
                 default:
-                    special_text_found = false;
                     break;
             }
 
             // Handle already found properties
             if (already_found)
-                sprint_warning_format("overwriting duplicate property: %s", statement.name);
+                sprint_warning_format("overwriting duplicate property: %s", sprint_parser_statement_name(&statement));
 
-            // Go to the next element, if a special text was found
-            if (special_text_found)
+            // Move a special text out of the list, since it is referenced on its own, and go to the next element
+            if (special_text != NULL) {
+                *special_text = sprint_parser_element_alloc_internal(parser);
+                if (*special_text == NULL) {
+                    error = SPRINT_ERROR_MEMORY;
+                    break;
+                }
+                **special_text = *child;
+                sprint_list_element_remove(&list);
                 continue;
+            }
         }
-
-        // Add the element
-        sprint_check(sprint_list_add(list, child));
     }
 
     // Ignore end of element errors and destroy the list on other errors
     if (error == SPRINT_ERROR_EOE)
         error = SPRINT_ERROR_NONE;
     else if (error != SPRINT_ERROR_NONE)
-        sprint_check(sprint_list_destroy(list));
+        sprint_list_element_destroy(&list);
 
     // Make sure that there are all properties
     if (!found_text_id || !found_text_value) {
@@ -1369,7 +1674,7 @@ static sprint_error sprint_parser_next_component_internal(sprint_parser* parser,
     }
 
     // Complete the list and check verify full validity
-    if (sprint_chain(error, sprint_list_complete(list, &element->component.num_elements, (void*) &element->component.elements)) &&
+    if (sprint_chain(error, sprint_list_element_complete(&list, parser->arena, &element->component.num_elements, &element->component.elements)) &&
         !sprint_assert(false, sprint_component_valid(&element->component)))
         error = SPRINT_ERROR_ASSERTION;
 
@@ -1384,6 +1689,7 @@ static sprint_error sprint_parser_next_group_internal(sprint_parser* parser, spr
     if (!sprint_chain(error, sprint_group_default(element, true)))
         return sprint_rethrow(error);
     element->parsed = true;
+    element->pooled = parser->arena != NULL;
 
     // Make sure that there are no properties
     if (parser->subsequent) {
@@ -1395,9 +1701,9 @@ static sprint_error sprint_parser_next_group_internal(sprint_parser* parser, spr
         if (sprint_check(error)) {
             error = SPRINT_ERROR_SYNTAX;
             if (sprint_parser_statement_flags(&statement, true, SPRINT_STATEMENT_FLAG_INDEX))
-                sprint_throw_format(false, "unexpected property index: %s%d", statement.name, statement.index);
+                sprint_throw_format(false, "unexpected property index: %s%d", sprint_parser_statement_name(&statement), statement.index);
             else
-                sprint_throw_format(false, "unknown property: %s", statement.name);
+                sprint_throw_format(false, "unknown property: %s", sprint_parser_statement_name(&statement));
         }
 
         // Destroy the statement
@@ -1408,36 +1714,38 @@ static sprint_error sprint_parser_next_group_internal(sprint_parser* parser, spr
     }
 
     // Read the elements
-    sprint_list* list = sprint_list_create(sizeof(sprint_element), 16);
-    if (list == NULL)
-        return SPRINT_ERROR_MEMORY;
+    sprint_list_element list = {0};
+    if (!sprint_chain(error, sprint_list_element_reserve(&list, 16)))
+        return sprint_rethrow(error);
     sprint_element* child = NULL;
     bool child_salvaged = false;
     while (true) {
-        // Read the next element
-        error = sprint_parser_next_element_internal(parser, &child, &child_salvaged, SPRINT_ELEMENT_GROUP, depth + 1);
-        if (error == SPRINT_ERROR_EOE || !sprint_check(error))
+        // Read the next element directly into a new slot at the end of the list
+        if (!sprint_chain(error, sprint_list_element_push(&list, &child)))
             break;
-
-        // Add the element
-        sprint_check(sprint_list_add(list, child));
+        error = sprint_parser_next_element_internal(parser, child, &child_salvaged, SPRINT_ELEMENT_GROUP, depth + 1);
+        *salvaged |= child_salvaged;
+        if (error == SPRINT_ERROR_EOE || !sprint_check(error)) {
+            sprint_list_element_remove(&list);
+            break;
+        }
     }
 
     // Ignore end of element errors and destroy the list on other errors
     if (error == SPRINT_ERROR_EOE)
         error = SPRINT_ERROR_NONE;
     else if (error != SPRINT_ERROR_NONE)
-        sprint_check(sprint_list_destroy(list));
+        sprint_list_element_destroy(&list);
 
     // Complete the list and check verify full validity
-    if (sprint_chain(error, sprint_list_complete(list, &element->group.num_elements, (void*) &element->group.elements)) &&
+    if (sprint_chain(error, sprint_list_element_complete(&list, parser->arena, &element->group.num_elements, &element->group.elements)) &&
         !sprint_assert(false, sprint_group_valid(&element->group)))
         error = SPRINT_ERROR_ASSERTION;
 
     return sprint_rethrow(error);
 }
 
-static sprint_error sprint_parser_next_element_internal(sprint_parser* parser, sprint_element** element,
+static sprint_error sprint_parser_next_element_internal(sprint_parser* parser, sprint_element* element,
                                                         bool* salvaged, sprint_element_type parent, int depth)
 {
     if (parser == NULL || element == NULL || salvaged == NULL) return SPRINT_ERROR_ARGUMENT_NULL;
@@ -1446,11 +1754,8 @@ static sprint_error sprint_parser_next_element_internal(sprint_parser* parser, s
     // Clear the salvaged flag
     *salvaged = false;
 
-    // Allocate the element
+    // The element is only written once a statement was found
     bool cleared = false;
-    *element = malloc(sizeof(**element));
-    if (*element == NULL)
-        return SPRINT_ERROR_MEMORY;
 
     // Keep reading statements until there is one that can be read
     sprint_statement statement;
@@ -1479,22 +1784,40 @@ static sprint_error sprint_parser_next_element_internal(sprint_parser* parser, s
         }
 
         // Clear the element
-        memset(*element, 0, sizeof(**element));
+        memset(element, 0, sizeof(*element));
         cleared = true;
 
         // If the depth is at least one and the parent a component, try to match the other text types first
         bool element_salvaged = false;
         sprint_text_type text_type = 0;
         if (depth > 0 && parent == SPRINT_ELEMENT_COMPONENT &&
-            sprint_text_type_from_keyword(&text_type, statement.name)) {
-            // Destroy the statement, read the text and update the subtype
+            sprint_text_type_from_keyword_id(&text_type, statement.keyword)) {
+            // Destroy the statement
             sprint_check(sprint_parser_statement_destroy(&statement));
-            if (sprint_chain(error, sprint_parser_next_text_internal(parser, *element, &element_salvaged)))
-                (*element)->text.subtype = text_type;
+
+            // Filter regular texts like any other element, but never the ID and value texts of the component
+            bool regular = text_type == SPRINT_TEXT_REGULAR;
+            if (regular && sprint_parser_excluded_internal(parser, SPRINT_ELEMENT_TEXT)) {
+                error = sprint_parser_skip_internal(parser, 0);
+                if (error != SPRINT_ERROR_NONE)
+                    break;
+                continue;
+            }
+            parser->layers = regular ? parser->filter.layers : 0;
+
+            // Read the text and update the subtype
+            if (sprint_chain(error, sprint_parser_next_text_internal(parser, element, &element_salvaged)))
+                element->text.subtype = text_type;
 
             // Update the salvaged flag
             *salvaged |= element_salvaged;
 
+            // Discard the text, if it was filtered out
+            if (regular && sprint_parser_rejected_internal(parser, element, error)) {
+                sprint_check(sprint_element_destroy_contents(element));
+                continue;
+            }
+
             // For any status other than a syntax error, stop the loop
             if (error != SPRINT_ERROR_SYNTAX)
                 break;
@@ -1508,7 +1831,7 @@ static sprint_error sprint_parser_next_element_internal(sprint_parser* parser, s
         // Otherwise, determine the type of the element
         sprint_element_type type = 0;
         bool closing = false;
-        bool success = sprint_element_type_from_keyword(&type, &closing, statement.name);
+        bool success = sprint_element_type_from_keyword_id(&type, &closing, statement.keyword);
 
         // Check, if the statement is a valid closing keyword
         if (closing && success) {
@@ -1531,34 +1854,45 @@ static sprint_error sprint_parser_next_element_internal(sprint_parser* parser, s
         if (closing)
             return SPRINT_ERROR_EOE;
 
+        // Skip elements of filtered types entirely, without decoding them
+        if (sprint_parser_excluded_internal(parser, type)) {
+            error = sprint_parser_skip_internal(parser, type == SPRINT_ELEMENT_COMPONENT || type == SPRINT_ELEMENT_GROUP);
+            if (error != SPRINT_ERROR_NONE)
+                break;
+            continue;
+        }
+
+        // Filter the layer of the element while reading it, which components and groups do not have
+        parser->layers = type != SPRINT_ELEMENT_COMPONENT && type != SPRINT_ELEMENT_GROUP ? parser->filter.layers : 0;
+
         // And dispatch to the correct parser
         switch (type) {
             case SPRINT_ELEMENT_TRACK:
-                sprint_chain(error, sprint_parser_next_track_internal(parser, *element, &element_salvaged));
+                sprint_chain(error, sprint_parser_next_track_internal(parser, element, &element_salvaged));
                 break;
             case SPRINT_ELEMENT_PAD_THT:
-                sprint_chain(error, sprint_parser_next_pad_tht_internal(parser, *element, &element_salvaged));
+                sprint_chain(error, sprint_parser_next_pad_tht_internal(parser, element, &element_salvaged));
                 break;
             case SPRINT_ELEMENT_PAD_SMT:
-                sprint_chain(error, sprint_parser_next_pad_smt_internal(parser, *element, &element_salvaged));
+                sprint_chain(error, sprint_parser_next_pad_smt_internal(parser, element, &element_salvaged));
                 break;
             case SPRINT_ELEMENT_ZONE:
-                sprint_chain(error, sprint_parser_next_zone_internal(parser, *element, &element_salvaged));
+                sprint_chain(error, sprint_parser_next_zone_internal(parser, element, &element_salvaged));
                 break;
             case SPRINT_ELEMENT_TEXT:
-                sprint_chain(error, sprint_parser_next_text_internal(parser, *element, &element_salvaged));
+                sprint_chain(error, sprint_parser_next_text_internal(parser, element, &element_salvaged));
                 break;
             case SPRINT_ELEMENT_CIRCLE:
-                sprint_chain(error, sprint_parser_next_circle_internal(parser, *element, &element_salvaged));
+                sprint_chain(error, sprint_parser_next_circle_internal(parser, element, &element_salvaged));
                 break;
             case SPRINT_ELEMENT_COMPONENT:
-                sprint_chain(error, sprint_parser_next_component_internal(parser, *element, &element_salvaged, depth));
+                sprint_chain(error, sprint_parser_next_component_internal(parser, element, &element_salvaged, depth));
                 break;
             case SPRINT_ELEMENT_GROUP:
-                sprint_chain(error, sprint_parser_next_group_internal(parser, *element, &element_salvaged, depth));
+                sprint_chain(error, sprint_parser_next_group_internal(parser, element, &element_salvaged, depth));
                 break;
             default:
-                sprint_check(sprint_element_destroy(*element));
+                sprint_check(sprint_element_destroy_contents(element));
                 sprint_throw_format(false, "element type unknown: %d", type);
                 return SPRINT_ERROR_INTERNAL;
         }
@@ -1566,6 +1900,12 @@ static sprint_error sprint_parser_next_element_internal(sprint_parser* parser, s
         // Update the salvaged flag
         *salvaged |= element_salvaged;
 
+        // Discard the element, if it was filtered out
+        if (sprint_parser_rejected_internal(parser, element, error)) {
+            sprint_check(sprint_element_destroy_contents(element));
+            continue;
+        }
+
         // Debug-log the element
         if (error == SPRINT_ERROR_NONE) {
             const char* element_name = sprint_element_type_valid(type) ? SPRINT_ELEMENT_TYPE_NAMES[type] : NULL;
@@ -1583,11 +1923,9 @@ static sprint_error sprint_parser_next_element_internal(sprint_parser* parser, s
         sprint_token_unexpected_internal(parser, true);
     }
 
-    // Destroy the element, if there was an error
-    if (!cleared)
-        free(*element);
-    else if (error != SPRINT_ERROR_NONE)
-        sprint_check(sprint_element_destroy(*element));
+    // Destroy the contents of the element, if there was an error
+    if (cleared && error != SPRINT_ERROR_NONE)
+        sprint_check(sprint_element_destroy_contents(element));
 
     // Make sure that there a cleared element, when there is no error
     if (!sprint_assert(false, cleared || error != SPRINT_ERROR_NONE))
@@ -1598,27 +1936,86 @@ static sprint_error sprint_parser_next_element_internal(sprint_parser* parser, s
 }
 #pragma clang diagnostic pop
 
+static sprint_element* sprint_parser_element_alloc_internal(sprint_parser* parser)
+{
+    if (parser->arena != NULL)
+        return sprint_arena_alloc(parser->arena, sizeof(sprint_element));
+    return malloc(sizeof(sprint_element));
+}
+
 sprint_error sprint_parser_next_element(sprint_parser* parser, sprint_element** element, bool* salvaged)
+{
+    if (parser == NULL || element == NULL || salvaged == NULL) return SPRINT_ERROR_ARGUMENT_NULL;
+
+    // Allocate the element
+    *element = sprint_parser_element_alloc_internal(parser);
+    if (*element == NULL)
+        return SPRINT_ERROR_MEMORY;
+
+    // Read into it and free it again, if that failed
+    sprint_error error = sprint_parser_next_element_internal(parser, *element, salvaged, 0, 0);
+    if (error != SPRINT_ERROR_NONE && parser->arena == NULL) {
+        free(*element);
+        *element = NULL;
+    }
+    return error;
+}
+
+sprint_error sprint_parser_next_element_into(sprint_parser* parser, sprint_element* element, bool* salvaged)
 {
     return sprint_parser_next_element_internal(parser, element, salvaged, 0, 0);
 }
 
+sprint_error sprint_parser_foreach_element(sprint_parser* parser, sprint_parser_visitor visitor, void* user,
+                                           bool* salvaged)
+{
+    if (parser == NULL || visitor == NULL || salvaged == NULL) return SPRINT_ERROR_ARGUMENT_NULL;
+
+    // Read each element into the same storage
+    *salvaged = false;
+    sprint_error error = SPRINT_ERROR_NONE;
+    sprint_element element;
+    while (true) {
+        bool element_salvaged = false;
+        error = sprint_parser_next_element_into(parser, &element, &element_salvaged);
+        *salvaged |= element_salvaged;
+
+        // Handle EOF
+        if (error == SPRINT_ERROR_EOF) {
+            error = SPRINT_ERROR_NONE;
+            break;
+        }
+        if (!sprint_check(error))
+            break;
+
+        // Visit the element, before destroying it again
+        sprint_chain(error, visitor(&element, user));
+        sprint_check(sprint_element_destroy_contents(&element));
+        if (error != SPRINT_ERROR_NONE)
+            break;
+    }
+
+    return sprint_rethrow(error);
+}
+
 sprint_error sprint_parser_destroy(sprint_parser* parser, bool tokenizer, char** contents)
 {
     if (parser == NULL) return SPRINT_ERROR_ARGUMENT_NULL;
 
+    // Store the contents of the last token, if desired, before its source may be closed
+    if (contents != NULL && parser->builder != NULL)
+        sprint_check(sprint_token_contents(&parser->token, parser->builder, contents));
+
+    // Destroy the builder
+    if (parser->builder != NULL)
+        sprint_check(sprint_stringbuilder_destroy(parser->builder));
+    parser->builder = NULL;
+
     // Destroy the tokenizer, if desired
     if (tokenizer && parser->tokenizer != NULL)
         sprint_check(sprint_tokenizer_destroy(parser->tokenizer));
     parser->tokenizer = NULL;
 
-    // Store the contents of the builder, if desired
-    if (contents != NULL && parser->builder != NULL) {
-        *contents = sprint_stringbuilder_complete(parser->builder);
-        sprint_assert(false, *contents != NULL);
-    }
-    parser->builder = NULL;
-
     // Free the memory
     free(parser);
     return SPRINT_ERROR_NONE;
@@ -10,8 +10,10 @@
 #include "primitives.h"
 #include "elements.h"
 #include "list.h"
+#include "arena.h"
 #include "stringbuilder.h"
 #include "token.h"
+#include "keyword.h"
 #include "errors.h"
 
 #include <stdbool.h>
@@ -30,23 +32,68 @@ typedef enum sprint_statement_flags {
 } sprint_statement_flags;
 
 typedef struct sprint_statement {
+    // The recognized keyword of the name
+    sprint_keyword keyword;
+    // The name is stored inline, unless it is too long and thus allocated
     char* name;
+    char buffer[32];
     sprint_statement_flags flags;
     int index;
 } sprint_statement;
+/**
+ * Gets the name of the statement as it was written.
+ * @param statement The statement to get the name of.
+ * @return The name, which remains valid until the statement is destroyed, or null if the statement is null.
+ */
 char* sprint_parser_statement_name(sprint_statement* statement);
+sprint_keyword sprint_parser_statement_keyword(sprint_statement* statement);
 bool sprint_parser_statement_flags(sprint_statement* statement, bool any, sprint_statement_flags flags);
 int sprint_parser_statement_index(sprint_statement* statement);
 sprint_error sprint_parser_statement_destroy(sprint_statement* statement);
 
+typedef sprint_error (*sprint_parser_visitor)(sprint_element* element, void* user);
+
+typedef struct sprint_element_filter {
+    // The element types to read as a mask of (1 << type), or zero to read all types
+    int types;
+    // The layers to read elements on as a mask of (1 << layer), or zero to read all layers
+    int layers;
+    // Decides whether to keep an element after reading it, such as by its bounding box, or null to keep all
+    bool (*predicate)(sprint_element* element, void* user);
+    void* user;
+} sprint_element_filter;
+
 typedef struct sprint_parser {
     sprint_tokenizer* tokenizer;
     sprint_stringbuilder* builder;
     sprint_token token;
     bool subsequent;
     bool value;
+    sprint_arena* arena;
+    sprint_element_filter filter;
+    // The layers that the element being read is kept on, and whether it turned out to be on another one
+    int layers;
+    bool filtered;
 } sprint_parser;
 sprint_parser* sprint_parser_create(sprint_tokenizer* tokenizer);
+/**
+ * Makes the parser allocate all elements it reads and their buffers from an arena instead of individually.
+ * The elements are then released together with the arena, rather than by destroying them.
+ * @param parser The parser instance.
+ * @param arena The arena to allocate from, which must outlive the elements, or null to allocate individually.
+ * @return No error returned on success.
+ */
+sprint_error sprint_parser_arena(sprint_parser* parser, sprint_arena* arena);
+/**
+ * Makes the parser only return the elements that match a filter.
+ * Elements of other types are skipped over at the token level, including the contents of components and groups,
+ * and elements on other layers as soon as their layer has been read, so neither is decoded or validated in full.
+ * The filter applies to the elements inside components and groups as well, except for their ID and value texts.
+ * @param parser The parser instance.
+ * @param filter The filter to copy, or null to read all elements again.
+ * @return No error returned on success.
+ */
+sprint_error sprint_parser_filter(sprint_parser* parser, const sprint_element_filter* filter);
 sprint_error sprint_parser_token(sprint_parser* parser, sprint_token* token);
 sprint_error sprint_parser_origin(sprint_parser* parser, sprint_source_origin* origin);
 sprint_error sprint_parser_next_statement(sprint_parser* parser, sprint_statement* statement, bool sync);
@@ -58,6 +105,27 @@ sprint_error sprint_parser_next_angle(sprint_parser* parser, sprint_angle* angle
 sprint_error sprint_parser_next_tuple(sprint_parser* parser, sprint_tuple* tuple);
 sprint_error sprint_parser_next_str(sprint_parser* parser, char** str);
 sprint_error sprint_parser_next_element(sprint_parser* parser, sprint_element** element, bool* salvaged);
+/**
+ * Reads the next element into storage provided by the caller, such as a slot pushed to a list.
+ * Unlike sprint_parser_next_element, this does not allocate the element itself.
+ * @param parser The parser instance.
+ * @param element The storage to write the element to, which is left in an unspecified state on errors.
+ * @param salvaged The target reference to write whether the element needed to be salvaged to.
+ * @return No error returned on success. At the end of input, returns EOF.
+ */
+sprint_error sprint_parser_next_element_into(sprint_parser* parser, sprint_element* element, bool* salvaged);
+/**
+ * Reads all remaining elements one at a time and passes each of them to a visitor, without keeping them.
+ * Each element is destroyed again after it has been visited, so the memory use does not depend on the input size,
+ * unless the parser allocates from an arena.
+ * @param parser The parser instance.
+ * @param visitor The function to pass each element to, which stops reading by returning an error.
+ * @param user The pointer to pass to the visitor.
+ * @param salvaged The target reference to write whether any element needed to be salvaged to.
+ * @return No error returned on success, or the first error of reading or visiting.
+ */
+sprint_error sprint_parser_foreach_element(sprint_parser* parser, sprint_parser_visitor visitor, void* user,
+                                           bool* salvaged);
 /**
  * Destroys the parser and releases its memory and resources.
  * @param parser The parser instance.
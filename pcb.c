@@ -9,8 +9,18 @@
 #include "output.h"
 #include "grid.h"
 #include "elements.h"
+#include "arena.h"
+#include "storage.h"
+#include "token.h"
+#include "parser.h"
 #include "errors.h"
 
+#include <stdlib.h>
+
+static sprint_error sprint_pcb_decode_internal(sprint_pcb* pcb, sprint_pcb_entry* entry);
+static bool sprint_pcb_verbatim_internal(sprint_pcb* pcb, sprint_pcb_entry* entry);
+static bool sprint_pcb_check_internal(sprint_pcb* pcb, sprint_pcb_entry* entry);
+
 const char* SPRINT_PCB_FLAG_NAMES[] = {
         "top fill",
         "bottom fill",
@@ -62,3 +72,188 @@ sprint_error sprint_pcb_output(sprint_pcb* pcb, sprint_output* output)
 
     return sprint_rethrow(error);
 }
+
+int sprint_pcb_count(sprint_pcb* pcb)
+{
+    if (pcb == NULL) return 0;
+    return pcb->entries != NULL ? pcb->num_entries : pcb->elements.count;
+}
+
+sprint_error sprint_pcb_type(sprint_pcb* pcb, int index, sprint_element_type* type)
+{
+    if (pcb == NULL || type == NULL) return SPRINT_ERROR_ARGUMENT_NULL;
+    if (index < 0 || index >= sprint_pcb_count(pcb)) return SPRINT_ERROR_ARGUMENT_RANGE;
+
+    *type = pcb->entries != NULL ? pcb->entries[index].type :
+            sprint_storage_get(&pcb->elements, index)->type;
+    return SPRINT_ERROR_NONE;
+}
+
+sprint_error sprint_pcb_element(sprint_pcb* pcb, int index, sprint_element** element)
+{
+    if (pcb == NULL || element == NULL) return SPRINT_ERROR_ARGUMENT_NULL;
+    if (index < 0 || index >= sprint_pcb_count(pcb)) return SPRINT_ERROR_ARGUMENT_RANGE;
+
+    // Loaded boards hold all elements already
+    if (pcb->entries == NULL) {
+        *element = sprint_storage_get(&pcb->elements, index);
+        return SPRINT_ERROR_NONE;
+    }
+
+    // Otherwise, decode the element on first access, after which it can be changed
+    sprint_pcb_entry* entry = &pcb->entries[index];
+    sprint_error error = SPRINT_ERROR_NONE;
+    if (entry->element == NULL && !sprint_chain(error, sprint_pcb_decode_internal(pcb, entry)))
+        return sprint_rethrow(error);
+    entry->dirty = true;
+    *element = entry->element;
+    return SPRINT_ERROR_NONE;
+}
+
+sprint_error sprint_pcb_inspect(sprint_pcb* pcb, int index, const sprint_element** element)
+{
+    if (pcb == NULL || element == NULL) return SPRINT_ERROR_ARGUMENT_NULL;
+    if (index < 0 || index >= sprint_pcb_count(pcb)) return SPRINT_ERROR_ARGUMENT_RANGE;
+
+    // Loaded boards hold all elements already
+    if (pcb->entries == NULL) {
+        *element = sprint_storage_get(&pcb->elements, index);
+        return SPRINT_ERROR_NONE;
+    }
+
+    // Otherwise, decode the element on first access
+    sprint_pcb_entry* entry = &pcb->entries[index];
+    sprint_error error = SPRINT_ERROR_NONE;
+    if (entry->element == NULL && !sprint_chain(error, sprint_pcb_decode_internal(pcb, entry)))
+        return sprint_rethrow(error);
+    *element = entry->element;
+    return SPRINT_ERROR_NONE;
+}
+
+bool sprint_pcb_verbatim(sprint_pcb* pcb, int index, int* count, const char** source, int* length)
+{
+    if (pcb == NULL || count == NULL || source == NULL || length == NULL) return false;
+    if (index < 0 || index >= pcb->num_entries || !sprint_pcb_verbatim_internal(pcb, &pcb->entries[index]))
+        return false;
+
+    // Join the following elements, as long as only a line break separates them
+    const char* block = pcb->source->block;
+    int start = pcb->entries[index].start, end = pcb->entries[index].end, joined = index + 1;
+    for (; joined < pcb->num_entries; joined++) {
+        sprint_pcb_entry* entry = &pcb->entries[joined];
+        if (entry->start != end + 1 || block[end] != '\n' || !sprint_pcb_verbatim_internal(pcb, entry))
+            break;
+        end = entry->end;
+    }
+
+    *count = joined - index;
+    *source = block + start;
+    *length = end - start;
+    return true;
+}
+
+sprint_error sprint_pcb_destroy(sprint_pcb* pcb)
+{
+    if (pcb == NULL) return SPRINT_ERROR_ARGUMENT_NULL;
+
+    // Destroy the decoded elements of the index, unless they are released with the arena
+    sprint_error error = SPRINT_ERROR_NONE;
+    if (pcb->entries != NULL && pcb->arena == NULL) {
+        for (int index = 0; index < pcb->num_entries; index++)
+            if (pcb->entries[index].element != NULL)
+                sprint_chain(error, sprint_element_destroy(pcb->entries[index].element));
+        free(pcb->entries);
+    }
+    pcb->entries = NULL;
+    pcb->num_entries = 0;
+
+    // Close the source of the index
+    if (pcb->source != NULL)
+        sprint_chain(error, sprint_tokenizer_destroy(pcb->source));
+    pcb->source = NULL;
+
+    // Release the elements from the arena at once, or destroy them one by one otherwise
+    if (pcb->arena != NULL)
+        sprint_chain(error, sprint_arena_destroy(pcb->arena));
+    else {
+        sprint_storage_iterator iterator;
+        sprint_element* element;
+        sprint_check(sprint_storage_begin(&pcb->elements, 0, pcb->elements.count, &iterator));
+        while (sprint_storage_next(&iterator, &element))
+            sprint_chain(error, sprint_element_destroy_contents(element));
+    }
+    sprint_chain(error, sprint_storage_destroy(&pcb->elements));
+
+    // Clear the references
+    pcb->arena = NULL;
+    return sprint_rethrow(error);
+}
+
+sprint_error sprint_pcb_decode_internal(sprint_pcb* pcb, sprint_pcb_entry* entry)
+{
+    // Parse the range of the element, which keeps the origins relative to the entire source
+    sprint_tokenizer* tokenizer = sprint_tokenizer_from_range(pcb->source, entry->start, entry->end);
+    if (tokenizer == NULL)
+        return SPRINT_ERROR_MEMORY;
+    sprint_parser* parser = sprint_parser_create(tokenizer);
+    if (parser == NULL) {
+        sprint_check(sprint_tokenizer_destroy(tokenizer));
+        return SPRINT_ERROR_MEMORY;
+    }
+    sprint_check(sprint_parser_arena(parser, pcb->arena));
+
+    // Read the element, whose range must not end before it
+    sprint_element* element = NULL;
+    bool salvaged = false;
+    sprint_error error = sprint_parser_next_element(parser, &element, &salvaged);
+    pcb->salvaged |= salvaged;
+    if (error == SPRINT_ERROR_EOF)
+        error = SPRINT_ERROR_SYNTAX;
+    else if (error == SPRINT_ERROR_NONE)
+        entry->element = element;
+
+    // Never write out the source of elements that needed to be salvaged or cannot be decoded at all
+    entry->dirty |= salvaged || error != SPRINT_ERROR_NONE;
+
+    // Destroy the parser and thus also the tokenizer
+    sprint_check(sprint_parser_destroy(parser, true, NULL));
+    return sprint_rethrow(error);
+}
+
+bool sprint_pcb_verbatim_internal(sprint_pcb* pcb, sprint_pcb_entry* entry)
+{
+    // Only unmodified plain elements of a source that is still mapped entirely can be written out as is
+    if (entry->dirty || !entry->plain || pcb->source == NULL || !pcb->source->persistent || pcb->source->block == NULL)
+        return false;
+
+    // Elements that were decoded or checked while indexing are fine, while the others must be checked first
+    return entry->element != NULL || entry->checked || sprint_pcb_check_internal(pcb, entry);
+}
+
+bool sprint_pcb_check_internal(sprint_pcb* pcb, sprint_pcb_entry* entry)
+{
+    // Parse the range of the element without an arena, so that the element can be destroyed right away
+    sprint_tokenizer* tokenizer = sprint_tokenizer_from_range(pcb->source, entry->start, entry->end);
+    if (tokenizer == NULL)
+        return false;
+    sprint_parser* parser = sprint_parser_create(tokenizer);
+    if (parser == NULL) {
+        sprint_check(sprint_tokenizer_destroy(tokenizer));
+        return false;
+    }
+
+    // Keep the diagnostics from being emitted, since they are emitted once the element is decoded for output
+    bool muted = sprint_error_mute(true);
+    sprint_element* element = NULL;
+    bool salvaged = false;
+    sprint_error error = sprint_parser_next_element(parser, &element, &salvaged);
+    if (element != NULL)
+        sprint_check(sprint_element_destroy(element));
+    sprint_check(sprint_parser_destroy(parser, true, NULL));
+    sprint_error_mute(muted);
+
+    // Elements that cannot be parsed cleanly are decoded and output like any modified ones
+    entry->checked = error == SPRINT_ERROR_NONE && !salvaged;
+    entry->dirty |= !entry->checked;
+    return entry->checked;
+}
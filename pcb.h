@@ -11,6 +11,9 @@
 #include "elements.h"
 #include "grid.h"
 #include "output.h"
+#include "arena.h"
+#include "storage.h"
+#include "token.h"
 #include "errors.h"
 
 #include <stdbool.h>
@@ -33,17 +36,91 @@ typedef enum sprint_pcb_flags {
 } sprint_pcb_flags;
 extern const char* SPRINT_PCB_FLAG_NAMES[];
 
+// Locates an element of the board inside the source, which is only decoded when it is first accessed
+typedef struct sprint_pcb_entry {
+    sprint_element_type type;
+    // The range of the element inside the source, and whether it consists of plain lines without comments or
+    // carriage returns, which could not be written out as is
+    int start;
+    int end;
+    bool plain;
+    // The decoded element, or null if it has not been accessed yet
+    sprint_element* element;
+    // Whether the element may have been modified, which keeps its source from being written out as is
+    bool dirty;
+    // Whether the source is known to parse cleanly without being decoded, which writing it out as is requires
+    bool checked;
+} sprint_pcb_entry;
+
 typedef struct sprint_pcb {
     sprint_dist width;
     sprint_dist height;
     sprint_grid grid;
     sprint_pcb_flags flags;
     bool salvaged;
-    int num_elements;
-    sprint_element* elements;
+    // The loaded elements, which keep their addresses when more are added
+    sprint_storage elements;
+    // The arena that the elements have been allocated from, or null if they have been allocated individually
+    sprint_arena* arena;
+    // The index of the elements and the source they are decoded from, or null if they have all been loaded
+    sprint_tokenizer* source;
+    int num_entries;
+    sprint_pcb_entry* entries;
 } sprint_pcb;
 
 sprint_error sprint_pcb_flags_output(sprint_pcb_flags flags, sprint_output* output);
 sprint_error sprint_pcb_output(sprint_pcb* pcb, sprint_output* output);
+/**
+ * Gets the number of top-level elements of the board, whether they have been loaded or indexed.
+ * @param pcb The board instance.
+ * @return The number of elements, or zero if the board is null.
+ */
+int sprint_pcb_count(sprint_pcb* pcb);
+/**
+ * Gets the type of a top-level element of the board, without decoding it.
+ * @param pcb The board instance.
+ * @param index The index of the element.
+ * @param type The target reference to write the type to.
+ * @return No error returned on success.
+ */
+sprint_error sprint_pcb_type(sprint_pcb* pcb, int index, sprint_element_type* type);
+/**
+ * Gets a top-level element of the board, decoding it from the source on first access if the board is indexed.
+ * The element is considered modified from then on, so it is output from its fields instead of its source.
+ * @param pcb The board instance.
+ * @param index The index of the element.
+ * @param element The target reference to write the element to, which is owned by the board.
+ * @return No error returned on success, or the error of decoding the element.
+ */
+sprint_error sprint_pcb_element(sprint_pcb* pcb, int index, sprint_element** element);
+/**
+ * Gets a top-level element of the board for reading only, which keeps it from being considered modified.
+ * @param pcb The board instance.
+ * @param index The index of the element.
+ * @param element The target reference to write the element to, which is owned by the board and must not be changed.
+ * @return No error returned on success, or the error of decoding the element.
+ */
+sprint_error sprint_pcb_inspect(sprint_pcb* pcb, int index, const sprint_element** element);
+/**
+ * Gets the source of the unmodified top-level elements of an indexed board starting at an index.
+ * Consecutive elements are joined, as long as they are only separated by a line break in the source.
+ * Elements whose source contains carriage returns or comments are never written out as is.
+ * Only sources which parse cleanly are written out as is, exactly like a full parse would write them, which is mostly
+ * known from indexing already. Other elements that have not been decoded yet are parsed once, without keeping them
+ * or emitting diagnostics.
+ * @param pcb The board instance.
+ * @param index The index of the first element.
+ * @param count The target reference to write the number of joined elements to.
+ * @param source The target reference to write the start of the source to, which is not terminated.
+ * @param length The target reference to write the length of the source to.
+ * @return Whether the element at the index can be written out as is.
+ */
+bool sprint_pcb_verbatim(sprint_pcb* pcb, int index, int* count, const char** source, int* length);
+/**
+ * Destroys all elements of the board, which releases its arena at once, if it has one, and closes its source.
+ * @param pcb The board to destroy the elements of.
+ * @return No error returned on success.
+ */
+sprint_error sprint_pcb_destroy(sprint_pcb* pcb);
 
 #endif //SPRINTTRACE_PCB_H
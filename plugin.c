@@ -7,8 +7,12 @@
 #include "plugin.h"
 #include "token.h"
 #include "parser.h"
+#include "loader.h"
 #include "pcb.h"
 #include "list.h"
+#include "arena.h"
+#include "snapshot.h"
+#include "writer.h"
 #include "stringbuilder.h"
 #include "errors.h"
 
@@ -16,14 +20,23 @@
 #include <stdio.h>
 #include <stdlib.h>
 
-#ifndef WIN32
+#ifdef WIN32
+#include <io.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#else
 #include <errno.h>
+#include <fcntl.h>
 #endif
 
 static bool sprint_plugin_parse_int_internal(int* output, const char* input);
 static bool sprint_plugin_parse_language_internal(int* output, const char* input);
 static sprint_error sprint_plugin_parse_flags_internal(int argc, const char* argv[]);
-static sprint_error sprint_plugin_parse_input_internal();
+static sprint_error sprint_plugin_parse_input_internal(bool lazy);
+static sprint_error sprint_plugin_begin_internal(int argc, const char* argv[], bool lazy);
+static sprint_error sprint_plugin_open_input_internal(sprint_tokenizer** tokenizer);
+static sprint_error sprint_plugin_open_output_internal(sprint_output** output);
+static sprint_error sprint_plugin_visit_internal(sprint_element* element, void* user);
 
 const char* SPRINT_LANGUAGE_NAMES[] = {
         [SPRINT_LANGUAGE_ENGLISH] = "English",
@@ -448,13 +461,17 @@ static sprint_error sprint_plugin_parse_flags_internal(int argc, const char* arg
     return SPRINT_ERROR_NONE;
 }
 
-static sprint_error sprint_plugin_parse_input_internal()
+static sprint_error sprint_plugin_open_input_internal(sprint_tokenizer** tokenizer)
 {
-    // Check the state
-    if (sprint_plugin.state != SPRINT_PLUGIN_STATE_PARSING_INPUT)
-        return SPRINT_ERROR_STATE_INVALID;
+    // Map the input file, so that the tokens can reference it directly
+    *tokenizer = sprint_tokenizer_from_mmap(sprint_plugin.input);
+    if (*tokenizer != NULL) {
+        // The mapping stays addressable, so positions only need to be resolved for warnings
+        sprint_assert(true, sprint_tokenizer_lazy(*tokenizer, true) == SPRINT_ERROR_NONE);
+        return SPRINT_ERROR_NONE;
+    }
 
-    // Open the input file
+    // Otherwise, fall back to reading the input file
     FILE* file = fopen(sprint_plugin.input, "r");
     if (file == NULL) {
         sprint_throw_format(false, "error opening file for reading: %s", strerror(errno));
@@ -462,51 +479,121 @@ static sprint_error sprint_plugin_parse_input_internal()
     }
 
     // Create the tokenizer
-    sprint_tokenizer* tokenizer = sprint_tokenizer_from_file(file, sprint_plugin.input, true);
-    sprint_assert(true, tokenizer != NULL);
+    *tokenizer = sprint_tokenizer_from_file(file, sprint_plugin.input, true);
+    sprint_assert(true, *tokenizer != NULL);
+    return SPRINT_ERROR_NONE;
+}
 
-    // Create the parser
-    sprint_parser* parser = sprint_parser_create(tokenizer);
-    sprint_assert(true, parser != NULL);
+static sprint_error sprint_plugin_open_output_internal(sprint_output** output)
+{
+    // Open the output file, whose writes are buffered by the output itself
+#ifdef WIN32
+    int descriptor = _open(sprint_plugin.output, _O_WRONLY | _O_CREAT | _O_TRUNC | _O_TEXT, _S_IREAD | _S_IWRITE);
+#else
+    int descriptor = open(sprint_plugin.output, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+#endif
+    if (descriptor < 0) {
+        sprint_throw_format(false, "error opening file for writing: %s", strerror(errno));
+        return SPRINT_ERROR_IO;
+    }
+
+    // Create the output
+    *output = sprint_output_create_descriptor(descriptor, true);
+    sprint_assert(true, *output != NULL);
+    return SPRINT_ERROR_NONE;
+}
+
+static sprint_error sprint_plugin_parse_input_internal(bool lazy)
+{
+    // Check the state
+    if (sprint_plugin.state != SPRINT_PLUGIN_STATE_PARSING_INPUT)
+        return SPRINT_ERROR_STATE_INVALID;
+
+    // Open the input file
+    sprint_tokenizer* tokenizer = NULL;
+    sprint_error error = sprint_plugin_open_input_internal(&tokenizer);
+    if (error != SPRINT_ERROR_NONE)
+        return sprint_rethrow(error);
 
-    // Create an element list
-    sprint_list* list = sprint_list_create(sizeof(*sprint_plugin.pcb.elements), 64);
-    sprint_assert(true, list);
+    // Create the arena that the elements are allocated from
+    sprint_plugin.pcb.arena = sprint_arena_create(true);
+    sprint_assert(true, sprint_plugin.pcb.arena);
 
     // Clear the salvaged flag
     sprint_plugin.pcb.salvaged = false;
 
-    // Parse all elements
-    sprint_error error;
-    sprint_element* element;
-    while (true) {
-        // Read the element
-        error = sprint_parser_next_element(parser, &element, &sprint_plugin.pcb.salvaged);
-
-        // Handle EOF
-        if (error == SPRINT_ERROR_EOF) {
-            error = SPRINT_ERROR_NONE;
-            break;
+    // Only index the elements, if desired, which keeps the input open to decode them from
+    if (lazy) {
+        sprint_list* entries = sprint_list_create(sizeof(*sprint_plugin.pcb.entries), 256);
+        sprint_assert(true, entries);
+        error = sprint_loader_index(tokenizer, entries);
+        if (error == SPRINT_ERROR_NONE) {
+            sprint_require(sprint_list_complete_arena(entries, sprint_plugin.pcb.arena, &sprint_plugin.pcb.num_entries,
+                                                      (void*) &sprint_plugin.pcb.entries));
+            sprint_plugin.pcb.source = tokenizer;
+            return SPRINT_ERROR_NONE;
         }
+        sprint_require(sprint_list_destroy(entries));
 
-        // Handle other errors and add the element
-        if (!sprint_check(error) || !sprint_chain(error, sprint_list_add(list, element)))
-            break;
+        // Fall back to parsing all elements, if the input cannot be indexed
+        if (error != SPRINT_ERROR_STATE_INVALID && error != SPRINT_ERROR_SYNTAX) {
+            sprint_require(sprint_pcb_destroy(&sprint_plugin.pcb));
+            sprint_require(sprint_tokenizer_destroy(tokenizer));
+            return sprint_rethrow(error);
+        }
     }
 
-    // Complete the element list, if it succeeded
-    if (error == SPRINT_ERROR_NONE)
-        sprint_require(sprint_list_complete(list, &sprint_plugin.pcb.num_elements, (void*) &sprint_plugin.pcb.elements));
-    else
-        sprint_require(sprint_list_destroy(list));
+    // Load the elements from the snapshot of the same input, if there is one, which skips parsing entirely
+    sprint_snapshot_key key;
+    char* snapshot = NULL;
+    if (sprint_snapshot_key_of(tokenizer, &key) == SPRINT_ERROR_NONE &&
+        sprint_snapshot_path(key, &snapshot) == SPRINT_ERROR_NONE &&
+        sprint_snapshot_read(&sprint_plugin.pcb, key, snapshot) == SPRINT_ERROR_NONE) {
+        free(snapshot);
+        sprint_require(sprint_tokenizer_destroy(tokenizer));
+        return SPRINT_ERROR_NONE;
+    }
 
-    // Destroy the parser (and thus also the tokenizer, and close the file)
-    sprint_require(sprint_parser_destroy(parser, true, NULL));
+    // Parse all elements straight into the board, using all processors for big inputs
+    error = sprint_loader_parse(tokenizer, 0, &sprint_plugin.pcb.elements, sprint_plugin.pcb.arena,
+                                &sprint_plugin.pcb.salvaged);
+    if (error == SPRINT_ERROR_NONE) {
+        // Take a snapshot for the next time, but only of cleanly parsed inputs, and without failing if it does not work
+        if (snapshot != NULL && !sprint_plugin.pcb.salvaged)
+            sprint_snapshot_write(&sprint_plugin.pcb, key, snapshot);
+    } else
+        sprint_require(sprint_pcb_destroy(&sprint_plugin.pcb));
+    free(snapshot);
+
+    // Destroy the tokenizer (and thus close the file)
+    sprint_require(sprint_tokenizer_destroy(tokenizer));
 
     return sprint_rethrow(error);
 }
 
+struct sprint_plugin_stream_context {
+    sprint_plugin_visitor visitor;
+    sprint_output* output;
+    void* user;
+};
+
+static sprint_error sprint_plugin_visit_internal(sprint_element* element, void* user)
+{
+    struct sprint_plugin_stream_context* context = user;
+    return context->visitor(element, context->output, context->user);
+}
+
 sprint_error sprint_plugin_begin(int argc, const char* argv[])
+{
+    return sprint_rethrow(sprint_plugin_begin_internal(argc, argv, false));
+}
+
+sprint_error sprint_plugin_begin_lazy(int argc, const char* argv[])
+{
+    return sprint_rethrow(sprint_plugin_begin_internal(argc, argv, true));
+}
+
+static sprint_error sprint_plugin_begin_internal(int argc, const char* argv[], bool lazy)
 {
     if (argv == NULL) return SPRINT_ERROR_ARGUMENT_NULL;
 
@@ -521,7 +608,7 @@ sprint_error sprint_plugin_begin(int argc, const char* argv[])
 
     // Parse the input
     sprint_plugin.state = SPRINT_PLUGIN_STATE_PARSING_INPUT;
-    if (!sprint_chain(error, sprint_plugin_parse_input_internal()))
+    if (!sprint_chain(error, sprint_plugin_parse_input_internal(lazy)))
         return sprint_rethrow(error);
 
     // Finally, update the state to processing and allow the plugin to run
@@ -559,21 +646,41 @@ sprint_error sprint_plugin_end(sprint_operation operation)
     // Handle operations that output data
     if (operation != SPRINT_OPERATION_NONE) {
         // Open the output file
-        FILE* file = fopen(sprint_plugin.output, "w");
-        if (file == NULL) {
-            sprint_throw_format(false, "error opening file for writing: %s", strerror(errno));
-            return SPRINT_ERROR_IO;
-        }
+        sprint_output* output = NULL;
+        sprint_error error = sprint_plugin_open_output_internal(&output);
+        if (error != SPRINT_ERROR_NONE)
+            return sprint_rethrow(error);
 
-        // Create the output
-        sprint_output* output = sprint_output_create_file(file, true);
-        sprint_assert(true, output != NULL);
+        // Output all elements, formatting them on all processors for big boards
+        if (sprint_plugin.pcb.entries == NULL)
+            error = sprint_writer_output(&sprint_plugin.pcb.elements, 0, output, SPRINT_PRIM_FORMAT_RAW);
+        else {
+            // Copy the unmodified elements of an indexed board straight from the source, decoding the others
+            for (int index = 0; index < sprint_pcb_count(&sprint_plugin.pcb); index++) {
+                int count, length;
+                const char* source;
+                if (sprint_pcb_verbatim(&sprint_plugin.pcb, index, &count, &source, &length)) {
+                    sprint_chain(error, sprint_output_put_bytes(output, source, length));
+                    if (!sprint_chain(error, sprint_output_put_chr(output, '\n')))
+                        break;
+                    index += count - 1;
+                    continue;
+                }
 
-        // Output all elements
-        sprint_error error = SPRINT_ERROR_NONE;
-        for (int index = 0; index < sprint_plugin.pcb.num_elements; index++)
-            if (!sprint_chain(error, sprint_element_output(&sprint_plugin.pcb.elements[index], output, SPRINT_PRIM_FORMAT_RAW)))
-                break;
+                sprint_element* element = NULL;
+                error = sprint_pcb_element(&sprint_plugin.pcb, index, &element);
+
+                // Drop indexed elements that turn out to be invalid, just like parsing them all would have
+                if (error == SPRINT_ERROR_SYNTAX) {
+                    sprint_plugin.pcb.salvaged = true;
+                    error = SPRINT_ERROR_NONE;
+                    continue;
+                }
+                if (!sprint_check(error) ||
+                    !sprint_chain(error, sprint_element_output(element, output, SPRINT_PRIM_FORMAT_RAW)))
+                    break;
+            }
+        }
 
         // Destroy the output (and thus close the file)
         sprint_require(sprint_output_destroy(output, NULL));
@@ -585,6 +692,66 @@ sprint_error sprint_plugin_end(sprint_operation operation)
             return sprint_rethrow(error);
     }
 
+    // Release the board
+    sprint_require(sprint_pcb_destroy(&sprint_plugin.pcb));
+
+    // Update the state
+    sprint_plugin.state = SPRINT_PLUGIN_STATE_COMPLETED;
+
+    // And exit
+    exit(operation);
+}
+
+sprint_error sprint_plugin_stream(int argc, const char* argv[], sprint_operation operation,
+                                  sprint_plugin_visitor visitor, void* user)
+{
+    if (argv == NULL || visitor == NULL) return SPRINT_ERROR_ARGUMENT_NULL;
+    if (!sprint_operation_valid(operation, false)) return SPRINT_ERROR_ARGUMENT_RANGE;
+
+    // Clear the plugin struct
+    memset(&sprint_plugin, 0, sizeof(sprint_plugin));
+
+    // Parse the flags
+    sprint_error error = SPRINT_ERROR_NONE;
+    sprint_plugin.state = SPRINT_PLUGIN_STATE_PARSING_FLAGS;
+    if (!sprint_chain(error, sprint_plugin_parse_flags_internal(argc, argv)))
+        return sprint_rethrow(error);
+
+    // Open the input file
+    sprint_plugin.state = SPRINT_PLUGIN_STATE_PARSING_INPUT;
+    sprint_tokenizer* tokenizer = NULL;
+    error = sprint_plugin_open_input_internal(&tokenizer);
+    if (error != SPRINT_ERROR_NONE)
+        return sprint_rethrow(error);
+
+    // Open the output file, if the operation outputs data
+    struct sprint_plugin_stream_context context = {.visitor = visitor, .user = user};
+    if (operation != SPRINT_OPERATION_NONE) {
+        error = sprint_plugin_open_output_internal(&context.output);
+        if (error != SPRINT_ERROR_NONE) {
+            sprint_require(sprint_tokenizer_destroy(tokenizer));
+            return sprint_rethrow(error);
+        }
+    }
+
+    // Visit the elements while they are parsed, without ever keeping more than one of them
+    sprint_plugin.state = SPRINT_PLUGIN_STATE_PROCESSING;
+    sprint_parser* parser = sprint_parser_create(tokenizer);
+    sprint_assert(true, parser);
+    sprint_chain(error, sprint_parser_foreach_element(parser, sprint_plugin_visit_internal, &context,
+                                                      &sprint_plugin.pcb.salvaged));
+
+    // Destroy the parser and the tokenizer (and thus close the files)
+    sprint_require(sprint_parser_destroy(parser, true, NULL));
+    if (context.output != NULL)
+        sprint_require(sprint_output_destroy(context.output, NULL));
+
+    // Check, if processing succeeded
+    if (error == SPRINT_ERROR_SYNTAX)
+        error = SPRINT_ERROR_PLUGIN_INPUT_SYNTAX;
+    if (error != SPRINT_ERROR_NONE)
+        return sprint_rethrow(error);
+
     // Update the state
     sprint_plugin.state = SPRINT_PLUGIN_STATE_COMPLETED;
 
@@ -78,7 +78,33 @@ extern const char SPRINT_FLAG_PREFIX;
 extern const char SPRINT_FLAG_DELIMITER;
 extern const char* SPRINT_OUTPUT_SUFFIX;
 
+// Visits an element of a streamed board, to which output may be written
+typedef sprint_error (*sprint_plugin_visitor)(sprint_element* element, sprint_output* output, void* user);
+
 sprint_error sprint_plugin_begin(int argc, const char* argv[]);
+/**
+ * Begins the plugin like sprint_plugin_begin, but only indexes the input elements instead of parsing them.
+ * The elements are decoded when they are first accessed using sprint_pcb_element, while sprint_pcb_count and
+ * sprint_pcb_type are available right away. Inputs that cannot be indexed are parsed entirely instead.
+ * @param argc The number of arguments passed to the process.
+ * @param argv The arguments passed to the process.
+ * @return No error returned on success.
+ */
+sprint_error sprint_plugin_begin_lazy(int argc, const char* argv[]);
+/**
+ * Runs the plugin over the input elements one at a time, instead of loading the whole board.
+ * Each top-level element is only valid during its visit and the board is never populated,
+ * so the memory used remains constant regardless of the size of the input.
+ * Exits the process with the operation after all elements have been visited.
+ * @param argc The number of arguments passed to the process.
+ * @param argv The arguments passed to the process.
+ * @param operation The operation to perform with the output.
+ * @param visitor The function to call for every element, which is passed null as output for no operation.
+ * @param user The user data to pass to the visitor.
+ * @return Only returns if an error occurred.
+ */
+sprint_error sprint_plugin_stream(int argc, const char* argv[], sprint_operation operation,
+                                  sprint_plugin_visitor visitor, void* user);
 sprint_error sprint_plugin_output(sprint_output* output);
 void sprint_plugin_bail(int error);
 sprint_error sprint_plugin_end(sprint_operation operation);
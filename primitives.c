@@ -87,11 +87,12 @@ sprint_error sprint_str_output(const char* str, sprint_output* output, sprint_pr
         str = "";
 
     // Write the string based on the format
-    if (sprint_prim_format_cooked(format))
-        return sprint_rethrow(sprint_output_format(output, "\"%s\"", str));
-    else
-        return sprint_rethrow(sprint_output_format(output, "%c%s%c",
-                                                   SPRINT_STRING_DELIMITER, str, SPRINT_STRING_DELIMITER));
+    char delimiter = sprint_prim_format_cooked(format) ? '"' : SPRINT_STRING_DELIMITER;
+    sprint_error error = SPRINT_ERROR_NONE;
+    sprint_chain(error, sprint_output_put_chr(output, delimiter));
+    sprint_chain(error, sprint_output_put_str(output, str));
+    sprint_chain(error, sprint_output_put_chr(output, delimiter));
+    return sprint_rethrow(error);
 }
 
 
@@ -198,8 +199,8 @@ sprint_error sprint_dist_output(sprint_dist dist, sprint_output* output, sprint_
 
     // Append the integer part, decimal point and mantissa
     sprint_error error = SPRINT_ERROR_NONE;
-    sprint_chain(error, sprint_output_format(output, "%d.%0*d", dist / dist_per_unit, dist_precision,
-                                             abs(dist % dist_per_unit)));
+    sprint_chain(error, sprint_output_put_fixed(output, dist / dist_per_unit, abs(dist % dist_per_unit),
+                                                dist_precision));
 
     // Append the unit suffix
     sprint_chain(error, sprint_output_put_str(output, dist_suffix));
@@ -244,8 +245,8 @@ sprint_error sprint_angle_output(sprint_angle angle, sprint_output* output, spri
     sprint_error error = SPRINT_ERROR_NONE;
     if (sprint_prim_format_cooked(format)) {
         // Append the integer part, decimal point and mantissa part
-        sprint_chain(error, sprint_output_format(output, "%d.%0*d", angle / SPRINT_ANGLE_NATIVE,
-                                                        SPRINT_ANGLE_PRECISION, abs(angle % SPRINT_ANGLE_NATIVE)));
+        sprint_chain(error, sprint_output_put_fixed(output, angle / SPRINT_ANGLE_NATIVE,
+                                                    abs(angle % SPRINT_ANGLE_NATIVE), SPRINT_ANGLE_PRECISION));
 
         // Append the unit suffix
         sprint_chain(error, sprint_output_put_str(output, "deg"));
@@ -0,0 +1,287 @@
+//
+// SprintTrace: segmented string builder
+// Copyright 2022, Laminoid.com (Muessig & Muessig GbR).
+// Licensed under the terms and conditions of the GPLv3.
+//
+
+#include "rope.h"
+#include "errors.h"
+
+#include <stdbool.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+
+#ifdef WIN32
+#include <io.h>
+#else
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+const size_t SPRINT_ROPE_SEGMENT_SIZE = 64 * 1024;
+
+struct sprint_rope_segment {
+    // The segment that follows this one
+    sprint_rope_segment* next;
+
+    // The number of characters in this segment
+    size_t used;
+
+    // The characters, which fill the rest of the segment
+    char bytes[];
+};
+
+static sprint_rope_segment* sprint_rope_append_internal(sprint_rope* rope);
+#ifdef WIN32
+static sprint_error sprint_rope_write_internal(const char* bytes, size_t length, void* user);
+#endif
+
+sprint_rope* sprint_rope_create(void)
+{
+    return calloc(1, sizeof(sprint_rope));
+}
+
+sprint_error sprint_rope_destroy(sprint_rope* rope)
+{
+    if (rope == NULL) return SPRINT_ERROR_ARGUMENT_NULL;
+
+    sprint_error error = sprint_rope_clear(rope);
+    free(rope);
+    return sprint_rethrow(error);
+}
+
+char* sprint_rope_complete(sprint_rope* rope)
+{
+    if (rope == NULL) return NULL;
+
+    // Join the segments, releasing each of them once it has been copied
+    char* result = malloc(rope->count + 1);
+    size_t count = 0;
+    while (rope->first != NULL) {
+        sprint_rope_segment* segment = rope->first;
+        rope->first = segment->next;
+        if (result != NULL) {
+            memcpy(result + count, segment->bytes, segment->used);
+            count += segment->used;
+        }
+        free(segment);
+    }
+
+    // Append a null terminator
+    if (result != NULL)
+        result[count] = 0;
+
+    // And finally, free the rope
+    free(rope);
+    return result;
+}
+
+size_t sprint_rope_count(sprint_rope* rope)
+{
+    return rope == NULL ? 0 : rope->count;
+}
+
+sprint_error sprint_rope_clear(sprint_rope* rope)
+{
+    if (rope == NULL) return SPRINT_ERROR_ARGUMENT_NULL;
+
+    // Release all segments
+    while (rope->first != NULL) {
+        sprint_rope_segment* segment = rope->first;
+        rope->first = segment->next;
+        free(segment);
+    }
+
+    rope->last = NULL;
+    rope->count = 0;
+    return SPRINT_ERROR_NONE;
+}
+
+sprint_error sprint_rope_put_chr(sprint_rope* rope, char chr)
+{
+    if (rope == NULL) return SPRINT_ERROR_ARGUMENT_NULL;
+
+    // Start a new segment, if the last one is full
+    sprint_rope_segment* segment = rope->last;
+    if (segment == NULL || segment->used >= SPRINT_ROPE_SEGMENT_SIZE) {
+        segment = sprint_rope_append_internal(rope);
+        if (segment == NULL)
+            return SPRINT_ERROR_MEMORY;
+    }
+
+    // Store the character
+    segment->bytes[segment->used++] = chr;
+    rope->count++;
+    return SPRINT_ERROR_NONE;
+}
+
+sprint_error sprint_rope_put_str(sprint_rope* rope, const char* str)
+{
+    if (str == NULL) return SPRINT_ERROR_ARGUMENT_NULL;
+    return sprint_rope_put_bytes(rope, str, strlen(str));
+}
+
+sprint_error sprint_rope_put_bytes(sprint_rope* rope, const char* bytes, size_t length)
+{
+    if (rope == NULL || bytes == NULL) return SPRINT_ERROR_ARGUMENT_NULL;
+
+    // Fill the last segment and continue in new ones, which never moves what has been put before
+    while (length > 0) {
+        sprint_rope_segment* segment = rope->last;
+        if (segment == NULL || segment->used >= SPRINT_ROPE_SEGMENT_SIZE) {
+            segment = sprint_rope_append_internal(rope);
+            if (segment == NULL)
+                return SPRINT_ERROR_MEMORY;
+        }
+
+        size_t chunk = SPRINT_ROPE_SEGMENT_SIZE - segment->used;
+        if (chunk > length)
+            chunk = length;
+        memcpy(segment->bytes + segment->used, bytes, chunk);
+        segment->used += chunk;
+        rope->count += chunk;
+        bytes += chunk;
+        length -= chunk;
+    }
+    return SPRINT_ERROR_NONE;
+}
+
+sprint_error sprint_rope_format(sprint_rope* rope, const char* format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    sprint_error error = sprint_rope_format_args(rope, format, args);
+    va_end(args);
+    return error;
+}
+
+sprint_error sprint_rope_format_args(sprint_rope* rope, const char* format, va_list args)
+{
+    if (rope == NULL || format == NULL) return SPRINT_ERROR_ARGUMENT_NULL;
+
+    // Format straight into the last segment, if it fits
+    va_list retry_args;
+    va_copy(retry_args, args);
+    sprint_rope_segment* segment = rope->last;
+    size_t available = segment != NULL ? SPRINT_ROPE_SEGMENT_SIZE - segment->used : 0;
+    int length = vsnprintf(available > 0 ? segment->bytes + segment->used : NULL, available, format, args);
+    if (length < 0) {
+        va_end(retry_args);
+        return SPRINT_ERROR_ARGUMENT_FORMAT;
+    }
+    if ((size_t) length < available) {
+        segment->used += length;
+        rope->count += length;
+        va_end(retry_args);
+        return SPRINT_ERROR_NONE;
+    }
+
+    // Otherwise, format it separately and put it then
+    char* formatted = malloc(length + 1);
+    if (formatted == NULL) {
+        va_end(retry_args);
+        return SPRINT_ERROR_MEMORY;
+    }
+    sprint_error error = vsnprintf(formatted, length + 1, format, retry_args) == length ?
+            sprint_rope_put_bytes(rope, formatted, length) : SPRINT_ERROR_ASSERTION;
+    va_end(retry_args);
+    free(formatted);
+    return sprint_rethrow(error);
+}
+
+sprint_error sprint_rope_write(sprint_rope* rope, int descriptor)
+{
+    if (rope == NULL) return SPRINT_ERROR_ARGUMENT_NULL;
+    if (descriptor < 0) return SPRINT_ERROR_ARGUMENT_RANGE;
+
+#ifdef WIN32
+    // Write the segments one after another
+    return sprint_rethrow(sprint_rope_foreach_segment(rope, sprint_rope_write_internal, &descriptor));
+#else
+    // Gather as many segments as fit into a single system call
+    struct iovec vectors[64];
+    sprint_rope_segment* segment = rope->first;
+    while (segment != NULL) {
+        int count = 0;
+        for (; segment != NULL && count < (int) (sizeof(vectors) / sizeof(*vectors)); segment = segment->next) {
+            if (segment->used == 0)
+                continue;
+            vectors[count].iov_base = segment->bytes;
+            vectors[count].iov_len = segment->used;
+            count++;
+        }
+
+        // Then write them, continuing after what has been written, if the call is interrupted or only partial
+        struct iovec* vector = vectors;
+        while (count > 0) {
+            ssize_t written = writev(descriptor, vector, count);
+            if (written < 0) {
+                if (errno == EINTR)
+                    continue;
+                sprint_throw_format(false, "error writing file: %s", strerror(errno));
+                return SPRINT_ERROR_IO;
+            }
+            for (; count > 0 && (size_t) written >= vector->iov_len; vector++, count--)
+                written -= (ssize_t) vector->iov_len;
+            if (count > 0) {
+                vector->iov_base = (char*) vector->iov_base + written;
+                vector->iov_len -= written;
+            }
+        }
+    }
+    return SPRINT_ERROR_NONE;
+#endif
+}
+
+sprint_error sprint_rope_foreach_segment(sprint_rope* rope, sprint_rope_visitor visitor, void* user)
+{
+    if (rope == NULL || visitor == NULL) return SPRINT_ERROR_ARGUMENT_NULL;
+
+    // Pass each non-empty segment to the visitor, until it returns an error
+    sprint_error error = SPRINT_ERROR_NONE;
+    for (sprint_rope_segment* segment = rope->first; segment != NULL; segment = segment->next)
+        if (segment->used > 0 && !sprint_chain(error, visitor(segment->bytes, segment->used, user)))
+            break;
+    return sprint_rethrow(error);
+}
+
+sprint_rope_segment* sprint_rope_append_internal(sprint_rope* rope)
+{
+    sprint_rope_segment* segment = malloc(sizeof(sprint_rope_segment) + SPRINT_ROPE_SEGMENT_SIZE);
+    if (segment == NULL)
+        return NULL;
+
+    // Link the segment after the last one
+    segment->next = NULL;
+    segment->used = 0;
+    if (rope->last != NULL)
+        rope->last->next = segment;
+    else
+        rope->first = segment;
+    rope->last = segment;
+    return segment;
+}
+
+#ifdef WIN32
+sprint_error sprint_rope_write_internal(const char* bytes, size_t length, void* user)
+{
+    // Write the bytes in pieces that the system call can take
+    int descriptor = *(int*) user;
+    while (length > 0) {
+        unsigned int chunk = length > INT_MAX ? INT_MAX : (unsigned int) length;
+        int written = _write(descriptor, bytes, chunk);
+        if (written < 0) {
+            sprint_throw_format(false, "error writing file: %s", strerror(errno));
+            return SPRINT_ERROR_IO;
+        }
+        bytes += written;
+        length -= written;
+    }
+    return SPRINT_ERROR_NONE;
+}
+#endif
@@ -0,0 +1,85 @@
+//
+// SprintTrace: segmented string builder
+// Copyright 2022, Laminoid.com (Muessig & Muessig GbR).
+// Licensed under the terms and conditions of the GPLv3.
+//
+
+#ifndef SPRINTTRACE_ROPE_H
+#define SPRINTTRACE_ROPE_H
+
+#include "errors.h"
+
+#include <stdbool.h>
+#include <stdarg.h>
+#include <stddef.h>
+
+extern const size_t SPRINT_ROPE_SEGMENT_SIZE;
+
+typedef struct sprint_rope_segment sprint_rope_segment;
+
+// Represents a string builder for large contents, which are kept in fixed-size segments that never move
+typedef struct sprint_rope {
+    // The first segment, which links to all following ones, and the segment that is currently appended to
+    sprint_rope_segment* first;
+    sprint_rope_segment* last;
+
+    // The number of characters in all segments
+    size_t count;
+} sprint_rope;
+
+typedef sprint_error (*sprint_rope_visitor)(const char* bytes, size_t length, void* user);
+
+/**
+ * Creates an empty rope, which allocates its segments as contents are put.
+ * @return The rope, or null if it could not be allocated.
+ */
+sprint_rope* sprint_rope_create(void);
+/**
+ * Destroys a rope and all of its segments.
+ * @param rope The rope to destroy.
+ * @return No error returned on success.
+ */
+sprint_error sprint_rope_destroy(sprint_rope* rope);
+/**
+ * Joins the contents of a rope into a single terminated string and destroys the rope.
+ * @param rope The rope to complete, which is destroyed even if joining fails.
+ * @return The contents, which must be freed by the caller, or null if they could not be allocated.
+ */
+char* sprint_rope_complete(sprint_rope* rope);
+size_t sprint_rope_count(sprint_rope* rope);
+/**
+ * Removes all contents of a rope and releases all of its segments.
+ * @param rope The rope instance.
+ * @return No error returned on success.
+ */
+sprint_error sprint_rope_clear(sprint_rope* rope);
+sprint_error sprint_rope_put_chr(sprint_rope* rope, char chr);
+sprint_error sprint_rope_put_str(sprint_rope* rope, const char* str);
+/**
+ * Puts a range of bytes, which need not be terminated and may span several segments.
+ * @param rope The rope instance.
+ * @param bytes The bytes to put.
+ * @param length The number of bytes to put.
+ * @return No error returned on success.
+ */
+sprint_error sprint_rope_put_bytes(sprint_rope* rope, const char* bytes, size_t length);
+sprint_error sprint_rope_format(sprint_rope* rope, const char* format, ...);
+sprint_error sprint_rope_format_args(sprint_rope* rope, const char* format, va_list args);
+/**
+ * Writes the contents of a rope to a file descriptor, passing many segments to each system call.
+ * The rope is left unchanged, so that it can be written again.
+ * @param rope The rope instance.
+ * @param descriptor The file descriptor to write to.
+ * @return No error returned on success. If writing fails, returns IO.
+ */
+sprint_error sprint_rope_write(sprint_rope* rope, int descriptor);
+/**
+ * Visits the segments of a rope in order, which allows processing the contents without joining them.
+ * @param rope The rope instance.
+ * @param visitor The function to pass each non-empty segment to, which stops visiting by returning an error.
+ * @param user The pointer to pass to the visitor.
+ * @return No error returned on success, or the error of the visitor.
+ */
+sprint_error sprint_rope_foreach_segment(sprint_rope* rope, sprint_rope_visitor visitor, void* user);
+
+#endif //SPRINTTRACE_ROPE_H
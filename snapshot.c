@@ -0,0 +1,727 @@
+//
+// SprintTrace: binary board snapshots
+// Copyright 2022, Laminoid.com (Muessig & Muessig GbR).
+// Licensed under the terms and conditions of the GPLv3.
+//
+
+#include "snapshot.h"
+#include "pcb.h"
+#include "elements.h"
+#include "storage.h"
+#include "arena.h"
+#include "stringbuilder.h"
+#include "list.h"
+#include "token.h"
+#include "errors.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef WIN32
+#include <windows.h>
+#include <process.h>
+#include <direct.h>
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#include <sys/utime.h>
+#define getpid _getpid
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utime.h>
+#endif
+
+const char SPRINT_SNAPSHOT_MAGIC[8] = {'S', 'P', 'R', 'I', 'N', 'T', 'S', 'N'};
+const uint32_t SPRINT_SNAPSHOT_VERSION = 2;
+
+// Elements are stored as they are, so changing their layout requires another version, which these sizes
+// of 64-bit targets catch by failing to compile, since C99 has no static assertions
+#if UINTPTR_MAX == UINT64_MAX
+typedef char sprint_snapshot_pad_tht_size[sizeof(sprint_pad_tht) == 80 ? 1 : -1];
+typedef char sprint_snapshot_pad_smt_size[sizeof(sprint_pad_smt) == 80 ? 1 : -1];
+typedef char sprint_snapshot_element_size[sizeof(sprint_element) == 88 ? 1 : -1];
+#endif
+const char* SPRINT_SNAPSHOT_CACHE_VARIABLE = "SPRINTTRACE_CACHE";
+const char* SPRINT_SNAPSHOT_PREFIX = "sprinttrace-";
+const char* SPRINT_SNAPSHOT_SUFFIX = ".snapshot";
+const char* SPRINT_SNAPSHOT_DIRECTORY = "sprinttrace";
+const int SPRINT_SNAPSHOT_CACHE_LIMIT = 8;
+
+static const uint64_t SPRINT_SNAPSHOT_HASH_BASIS = 14695981039346656037ULL;
+static const uint64_t SPRINT_SNAPSHOT_HASH_PRIME = 1099511628211ULL;
+
+// A snapshot inside the cache directory, which is found when evicting
+typedef struct sprint_snapshot_file {
+    char* path;
+    uint64_t modified;
+} sprint_snapshot_file;
+SPRINT_LIST_DEFINE(sprint_snapshot_file, snapshot_file)
+
+static char* sprint_snapshot_join_internal(const char* directory, const char* name);
+static sprint_error sprint_snapshot_directory_internal(char** directory);
+static void sprint_snapshot_mkdir_internal(const char* directory);
+static bool sprint_snapshot_private_internal(const char* directory);
+static bool sprint_snapshot_named_internal(const char* name);
+static int sprint_snapshot_compare_internal(const void* first, const void* second);
+static void sprint_snapshot_evict_internal(const char* path);
+static size_t sprint_snapshot_align_internal(size_t size);
+static size_t sprint_snapshot_size_internal(const void* data, size_t size);
+static size_t sprint_snapshot_measure_internal(sprint_element* elements, int count);
+static size_t sprint_snapshot_measure_element_internal(sprint_element* element);
+static uintptr_t sprint_snapshot_put_internal(char* blob, size_t* offset, const void* data, size_t size);
+static uintptr_t sprint_snapshot_put_str_internal(char* blob, size_t* offset, const char* str);
+static uintptr_t sprint_snapshot_copy_internal(char* blob, size_t* offset, sprint_element* elements, int count);
+static void sprint_snapshot_relocate_internal(char* blob, size_t* offset, sprint_element* copy);
+static bool sprint_snapshot_fixup_internal(char* blob, size_t length, void** pointer, size_t size, bool required);
+static bool sprint_snapshot_fixup_str_internal(char* blob, size_t length, char** str);
+static bool sprint_snapshot_fixup_elements_internal(char* blob, size_t length, sprint_element* elements, int count,
+                                                    int depth);
+
+sprint_error sprint_snapshot_key_of(sprint_tokenizer* tokenizer, sprint_snapshot_key* key)
+{
+    if (tokenizer == NULL || key == NULL) return SPRINT_ERROR_ARGUMENT_NULL;
+    if (!tokenizer->persistent || tokenizer->block == NULL) return SPRINT_ERROR_STATE_INVALID;
+
+    // Hash eight bytes at a time in the manner of FNV-1a, folding the upper half back in to mix all bits
+    const char* data = tokenizer->block;
+    size_t length = tokenizer->block_end - tokenizer->block, offset = 0;
+    uint64_t hash = SPRINT_SNAPSHOT_HASH_BASIS;
+    for (; offset + sizeof(uint64_t) <= length; offset += sizeof(uint64_t)) {
+        uint64_t word;
+        memcpy(&word, data + offset, sizeof(word));
+        hash = (hash ^ word) * SPRINT_SNAPSHOT_HASH_PRIME;
+        hash ^= hash >> 32;
+    }
+    for (; offset < length; offset++)
+        hash = (hash ^ (unsigned char) data[offset]) * SPRINT_SNAPSHOT_HASH_PRIME;
+
+    key->hash = hash;
+    key->size = length;
+    return SPRINT_ERROR_NONE;
+}
+
+sprint_error sprint_snapshot_path(sprint_snapshot_key key, char** path)
+{
+    if (path == NULL) return SPRINT_ERROR_ARGUMENT_NULL;
+
+    // Determine the cache directory, which can be turned off by leaving it empty
+    const char* configured = getenv(SPRINT_SNAPSHOT_CACHE_VARIABLE);
+    if (configured != NULL && *configured == 0)
+        return SPRINT_ERROR_STATE_INVALID;
+    char* directory = NULL;
+    if (configured != NULL) {
+        sprint_stringbuilder* builder = sprint_stringbuilder_of(configured);
+        directory = builder != NULL ? sprint_stringbuilder_complete(builder) : NULL;
+    } else {
+        sprint_error error = sprint_snapshot_directory_internal(&directory);
+        if (error != SPRINT_ERROR_NONE)
+            return sprint_rethrow(error);
+    }
+    if (directory == NULL)
+        return SPRINT_ERROR_MEMORY;
+
+    // Only use a directory that no one else can place snapshots into, since they are loaded as they are
+    if (!sprint_snapshot_private_internal(directory)) {
+        free(directory);
+        return SPRINT_ERROR_STATE_INVALID;
+    }
+
+    // Name the snapshot after the key of the input
+    char name[64];
+    snprintf(name, sizeof(name), "%s%016llx%08llx%s", SPRINT_SNAPSHOT_PREFIX, (unsigned long long) key.hash,
+             (unsigned long long) key.size, SPRINT_SNAPSHOT_SUFFIX);
+    *path = sprint_snapshot_join_internal(directory, name);
+    free(directory);
+    return *path != NULL ? SPRINT_ERROR_NONE : SPRINT_ERROR_MEMORY;
+}
+
+sprint_error sprint_snapshot_read(sprint_pcb* pcb, sprint_snapshot_key key, const char* path)
+{
+    if (pcb == NULL || path == NULL) return SPRINT_ERROR_ARGUMENT_NULL;
+    if (pcb->arena == NULL || pcb->elements.count > 0 || pcb->entries != NULL) return SPRINT_ERROR_STATE_INVALID;
+
+    FILE* file = fopen(path, "rb");
+    if (file == NULL)
+        return SPRINT_ERROR_IO;
+
+    // Check the header first, which rejects stale snapshots without reading them entirely
+    sprint_snapshot_header header;
+    if (fread(&header, sizeof(header), 1, file) != 1) {
+        fclose(file);
+        return SPRINT_ERROR_IO;
+    }
+    size_t start = sprint_snapshot_align_internal(sizeof(header));
+    if (memcmp(header.magic, SPRINT_SNAPSHOT_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != SPRINT_SNAPSHOT_VERSION || header.element_size != sizeof(sprint_element) ||
+        header.pointer_size != sizeof(void*) || header.key.hash != key.hash || header.key.size != key.size) {
+        fclose(file);
+        return SPRINT_ERROR_STATE_INVALID;
+    }
+    if (header.num_elements < 0 || header.length > SIZE_MAX ||
+        header.length < start + (uint64_t) header.num_elements * sizeof(sprint_element)) {
+        fclose(file);
+        return SPRINT_ERROR_ARGUMENT_FORMAT;
+    }
+
+    // Read the rest of the snapshot in a single go
+    size_t length = (size_t) header.length;
+    char* blob = sprint_arena_alloc(pcb->arena, length);
+    if (blob == NULL) {
+        fclose(file);
+        return SPRINT_ERROR_MEMORY;
+    }
+    memcpy(blob, &header, sizeof(header));
+    bool complete = fread(blob + sizeof(header), 1, length - sizeof(header), file) == length - sizeof(header);
+    fclose(file);
+    if (!complete)
+        return SPRINT_ERROR_IO;
+
+    // Turn the offsets back into pointers, which also makes sure that the snapshot is not damaged
+    sprint_element* elements = (sprint_element*) (blob + start);
+    if (!sprint_snapshot_fixup_elements_internal(blob, length, elements, header.num_elements, 0))
+        return SPRINT_ERROR_ARGUMENT_FORMAT;
+
+    // Copy the top-level elements into the board, while everything they reference is released with the arena
+    sprint_error error = sprint_storage_add_all(&pcb->elements, elements, header.num_elements);
+    if (error != SPRINT_ERROR_NONE)
+        return sprint_rethrow(error);
+    pcb->salvaged = false;
+
+    // Mark the snapshot as recently used, which keeps it from being evicted
+#ifdef WIN32
+    _utime(path, NULL);
+#else
+    utime(path, NULL);
+#endif
+    return SPRINT_ERROR_NONE;
+}
+
+sprint_error sprint_snapshot_write(sprint_pcb* pcb, sprint_snapshot_key key, const char* path)
+{
+    if (pcb == NULL || path == NULL) return SPRINT_ERROR_ARGUMENT_NULL;
+    if (pcb->entries != NULL) return SPRINT_ERROR_STATE_INVALID;
+
+    // Measure the snapshot, so that it can be assembled in a single buffer
+    int count = pcb->elements.count;
+    sprint_storage_iterator iterator;
+    sprint_element* element;
+    size_t start = sprint_snapshot_align_internal(sizeof(sprint_snapshot_header));
+    size_t length = start + sprint_snapshot_align_internal(count * sizeof(sprint_element));
+    sprint_check(sprint_storage_begin(&pcb->elements, 0, count, &iterator));
+    while (sprint_storage_next(&iterator, &element))
+        length += sprint_snapshot_measure_element_internal(element);
+    char* blob = calloc(1, length);
+    if (blob == NULL)
+        return SPRINT_ERROR_MEMORY;
+
+    // Fill in the header
+    sprint_snapshot_header* header = (sprint_snapshot_header*) blob;
+    memcpy(header->magic, SPRINT_SNAPSHOT_MAGIC, sizeof(header->magic));
+    header->version = SPRINT_SNAPSHOT_VERSION;
+    header->element_size = sizeof(sprint_element);
+    header->pointer_size = sizeof(void*);
+    header->key = key;
+    header->length = length;
+    header->num_elements = count;
+
+    // Copy the elements into a single array and everything they reference behind it
+    sprint_element* copies = (sprint_element*) (blob + start);
+    size_t offset = start + sprint_snapshot_align_internal(count * sizeof(sprint_element));
+    sprint_check(sprint_storage_begin(&pcb->elements, 0, count, &iterator));
+    while (sprint_storage_next(&iterator, &element)) {
+        *copies = *element;
+        sprint_snapshot_relocate_internal(blob, &offset, copies++);
+    }
+    if (!sprint_assert(false, offset == length)) {
+        free(blob);
+        return SPRINT_ERROR_ASSERTION;
+    }
+
+    // Write to a temporary file first, so that no reader ever sees a partial snapshot
+    sprint_stringbuilder* builder = sprint_stringbuilder_of(path);
+    if (builder == NULL) {
+        free(blob);
+        return SPRINT_ERROR_MEMORY;
+    }
+    sprint_error error = SPRINT_ERROR_NONE;
+#ifdef WIN32
+    sprint_chain(error, sprint_stringbuilder_format(builder, ".%d.tmp", (int) getpid()));
+#else
+    sprint_chain(error, sprint_stringbuilder_put_str(builder, ".XXXXXX"));
+#endif
+    char* temp = sprint_stringbuilder_complete(builder);
+    if (error != SPRINT_ERROR_NONE || temp == NULL) {
+        free(temp);
+        free(blob);
+        return error != SPRINT_ERROR_NONE ? sprint_rethrow(error) : SPRINT_ERROR_MEMORY;
+    }
+
+    // Create it exclusively, so that nothing that is already there, like a link, is ever written through
+#ifdef WIN32
+    int descriptor = _open(temp, _O_WRONLY | _O_CREAT | _O_EXCL | _O_BINARY, _S_IREAD | _S_IWRITE);
+    FILE* file = descriptor >= 0 ? _fdopen(descriptor, "wb") : NULL;
+    if (descriptor >= 0 && file == NULL)
+        _close(descriptor);
+#else
+    int descriptor = mkstemp(temp);
+    FILE* file = descriptor >= 0 ? fdopen(descriptor, "wb") : NULL;
+    if (descriptor >= 0 && file == NULL)
+        close(descriptor);
+#endif
+    if (descriptor < 0) {
+        free(temp);
+        free(blob);
+        return SPRINT_ERROR_IO;
+    }
+    bool written = file != NULL && fwrite(blob, 1, length, file) == length;
+    if (file != NULL)
+        written &= fclose(file) == 0;
+    free(blob);
+
+    // Then replace the snapshot with it
+#ifdef WIN32
+    if (written)
+        remove(path);
+#endif
+    if (!written || rename(temp, path) != 0) {
+        remove(temp);
+        error = SPRINT_ERROR_IO;
+    }
+    free(temp);
+
+    // Keep the cache from growing without bounds
+    if (error == SPRINT_ERROR_NONE)
+        sprint_snapshot_evict_internal(path);
+    return error;
+}
+
+static char* sprint_snapshot_join_internal(const char* directory, const char* name)
+{
+#ifdef WIN32
+    const char separator = '\\';
+#else
+    const char separator = '/';
+#endif
+    sprint_stringbuilder* builder = sprint_stringbuilder_of(directory);
+    if (builder == NULL)
+        return NULL;
+
+    // Only add a separator, if the directory does not end with one already
+    sprint_error error = SPRINT_ERROR_NONE;
+    size_t length = strlen(directory);
+    if (length > 0 && directory[length - 1] != '/' && directory[length - 1] != separator)
+        sprint_chain(error, sprint_stringbuilder_put_chr(builder, separator));
+    sprint_chain(error, sprint_stringbuilder_put_str(builder, name));
+    char* path = sprint_stringbuilder_complete(builder);
+    if (error != SPRINT_ERROR_NONE) {
+        free(path);
+        return NULL;
+    }
+    return path;
+}
+
+static sprint_error sprint_snapshot_directory_internal(char** directory)
+{
+    // Use the cache directory of the user, which is the local application data on Windows
+#ifdef WIN32
+    const char* base = getenv("LOCALAPPDATA");
+    if (base == NULL || *base == 0)
+        return SPRINT_ERROR_STATE_INVALID;
+    *directory = sprint_snapshot_join_internal(base, SPRINT_SNAPSHOT_DIRECTORY);
+#else
+    // Otherwise, follow the base directory specification, which only allows absolute paths
+    const char* base = getenv("XDG_CACHE_HOME");
+    char* cache = NULL;
+    if (base == NULL || *base != '/') {
+        const char* home = getenv("HOME");
+        if (home == NULL || *home == 0)
+            return SPRINT_ERROR_STATE_INVALID;
+        cache = sprint_snapshot_join_internal(home, ".cache");
+        if (cache == NULL)
+            return SPRINT_ERROR_MEMORY;
+        sprint_snapshot_mkdir_internal(cache);
+        base = cache;
+    }
+    *directory = sprint_snapshot_join_internal(base, SPRINT_SNAPSHOT_DIRECTORY);
+    free(cache);
+#endif
+    if (*directory == NULL)
+        return SPRINT_ERROR_MEMORY;
+
+    // Create the directory, if it does not exist yet, which is checked once it is used
+    sprint_snapshot_mkdir_internal(*directory);
+    return SPRINT_ERROR_NONE;
+}
+
+static void sprint_snapshot_mkdir_internal(const char* directory)
+{
+#ifdef WIN32
+    _mkdir(directory);
+#else
+    mkdir(directory, 0700);
+#endif
+}
+
+static bool sprint_snapshot_private_internal(const char* directory)
+{
+#ifdef WIN32
+    // Directories are only checked for existence, since the default one is private to the user already
+    DWORD attributes = GetFileAttributesA(directory);
+    return attributes != INVALID_FILE_ATTRIBUTES && (attributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+#else
+    // The directory must belong to the user and must not be writable by anyone else
+    struct stat status;
+    return stat(directory, &status) == 0 && S_ISDIR(status.st_mode) && status.st_uid == geteuid() &&
+           (status.st_mode & (S_IWGRP | S_IWOTH)) == 0;
+#endif
+}
+
+static bool sprint_snapshot_named_internal(const char* name)
+{
+    size_t length = strlen(name), prefix = strlen(SPRINT_SNAPSHOT_PREFIX), suffix = strlen(SPRINT_SNAPSHOT_SUFFIX);
+    return length > prefix + suffix && strncmp(name, SPRINT_SNAPSHOT_PREFIX, prefix) == 0 &&
+           strcmp(name + length - suffix, SPRINT_SNAPSHOT_SUFFIX) == 0;
+}
+
+static int sprint_snapshot_compare_internal(const void* first, const void* second)
+{
+    // Order the most recently used snapshots first
+    uint64_t first_modified = ((const sprint_snapshot_file*) first)->modified;
+    uint64_t second_modified = ((const sprint_snapshot_file*) second)->modified;
+    return first_modified < second_modified ? 1 : first_modified > second_modified ? -1 : 0;
+}
+
+static void sprint_snapshot_evict_internal(const char* path)
+{
+    // Determine the directory of the snapshot
+    const char* end = strrchr(path, '/');
+#ifdef WIN32
+    const char* backslash = strrchr(path, '\\');
+    if (backslash != NULL && (end == NULL || backslash > end))
+        end = backslash;
+#endif
+    if (end == NULL)
+        return;
+    size_t length = (size_t) (end - path) + 1;
+    char* directory = malloc(length + 1);
+    if (directory == NULL)
+        return;
+    memcpy(directory, path, length);
+    directory[length] = 0;
+
+    // Find all snapshots in it along with the time they have last been used
+    sprint_list_snapshot_file files = {0};
+#ifdef WIN32
+    char pattern[MAX_PATH + 1];
+    snprintf(pattern, sizeof(pattern), "%s%s*%s", directory, SPRINT_SNAPSHOT_PREFIX, SPRINT_SNAPSHOT_SUFFIX);
+    WIN32_FIND_DATAA data;
+    HANDLE find = FindFirstFileA(pattern, &data);
+    if (find != INVALID_HANDLE_VALUE) {
+        do {
+            if ((data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0 ||
+                !sprint_snapshot_named_internal(data.cFileName))
+                continue;
+            sprint_snapshot_file file = {
+                    .path = sprint_snapshot_join_internal(directory, data.cFileName),
+                    .modified = ((uint64_t) data.ftLastWriteTime.dwHighDateTime << 32) |
+                                data.ftLastWriteTime.dwLowDateTime
+            };
+            if (file.path != NULL && sprint_list_snapshot_file_add(&files, file) != SPRINT_ERROR_NONE)
+                free(file.path);
+        } while (FindNextFileA(find, &data));
+        FindClose(find);
+    }
+#else
+    DIR* stream = opendir(directory);
+    if (stream != NULL) {
+        struct dirent* entry;
+        while ((entry = readdir(stream)) != NULL) {
+            if (!sprint_snapshot_named_internal(entry->d_name))
+                continue;
+            struct stat status;
+            sprint_snapshot_file file = {.path = sprint_snapshot_join_internal(directory, entry->d_name)};
+            if (file.path == NULL || lstat(file.path, &status) != 0 || !S_ISREG(status.st_mode)) {
+                free(file.path);
+                continue;
+            }
+            file.modified = (uint64_t) status.st_mtime;
+            if (sprint_list_snapshot_file_add(&files, file) != SPRINT_ERROR_NONE)
+                free(file.path);
+        }
+        closedir(stream);
+    }
+#endif
+    free(directory);
+
+    // Then remove all but the most recently used ones
+    if (files.count > 0)
+        qsort(files.elements, files.count, sizeof(*files.elements), sprint_snapshot_compare_internal);
+    for (int index = 0; index < files.count; index++) {
+        if (index >= SPRINT_SNAPSHOT_CACHE_LIMIT)
+            remove(files.elements[index].path);
+        free(files.elements[index].path);
+    }
+    sprint_list_snapshot_file_destroy(&files);
+}
+
+static size_t sprint_snapshot_align_internal(size_t size)
+{
+    return (size + sizeof(uint64_t) - 1) & ~(sizeof(uint64_t) - 1);
+}
+
+static size_t sprint_snapshot_size_internal(const void* data, size_t size)
+{
+    return data != NULL ? sprint_snapshot_align_internal(size) : 0;
+}
+
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "misc-no-recursion"
+static size_t sprint_snapshot_measure_internal(sprint_element* elements, int count)
+{
+    if (elements == NULL) return 0;
+
+    size_t size = sprint_snapshot_align_internal(count * sizeof(sprint_element));
+    for (int index = 0; index < count; index++)
+        size += sprint_snapshot_measure_element_internal(&elements[index]);
+    return size;
+}
+
+static size_t sprint_snapshot_measure_element_internal(sprint_element* element)
+{
+    // Measure everything the element references
+    size_t size = 0;
+    const char* name = NULL;
+    switch (element->type) {
+        case SPRINT_ELEMENT_TRACK:
+            size += sprint_snapshot_size_internal(element->track.points,
+                                                  element->track.num_points * sizeof(*element->track.points));
+            name = element->track.name;
+            break;
+        case SPRINT_ELEMENT_PAD_THT:
+            size += sprint_snapshot_size_internal(element->pad_tht.link.connections,
+                                                  element->pad_tht.link.num_connections * sizeof(int));
+            name = element->pad_tht.name;
+            break;
+        case SPRINT_ELEMENT_PAD_SMT:
+            size += sprint_snapshot_size_internal(element->pad_smt.link.connections,
+                                                  element->pad_smt.link.num_connections * sizeof(int));
+            name = element->pad_smt.name;
+            break;
+        case SPRINT_ELEMENT_ZONE:
+            size += sprint_snapshot_size_internal(element->zone.points,
+                                                  element->zone.num_points * sizeof(*element->zone.points));
+            name = element->zone.name;
+            break;
+        case SPRINT_ELEMENT_TEXT:
+            if (element->text.text != NULL)
+                size += sprint_snapshot_align_internal(strlen(element->text.text) + 1);
+            name = element->text.name;
+            break;
+        case SPRINT_ELEMENT_CIRCLE:
+            name = element->circle.name;
+            break;
+        case SPRINT_ELEMENT_COMPONENT:
+            size += sprint_snapshot_measure_internal(element->component.text_id, 1);
+            size += sprint_snapshot_measure_internal(element->component.text_value, 1);
+            size += sprint_snapshot_measure_internal(element->component.elements, element->component.num_elements);
+            if (element->component.comment != NULL)
+                size += sprint_snapshot_align_internal(strlen(element->component.comment) + 1);
+            name = element->component.package;
+            break;
+        case SPRINT_ELEMENT_GROUP:
+            size += sprint_snapshot_measure_internal(element->group.elements, element->group.num_elements);
+            break;
+    }
+    if (name != NULL)
+        size += sprint_snapshot_align_internal(strlen(name) + 1);
+    return size;
+}
+#pragma clang diagnostic pop
+
+static uintptr_t sprint_snapshot_put_internal(char* blob, size_t* offset, const void* data, size_t size)
+{
+    // Null pointers are stored as offset zero, which is taken by the header
+    if (data == NULL) return 0;
+
+    uintptr_t position = *offset;
+    memcpy(blob + position, data, size);
+    *offset += sprint_snapshot_align_internal(size);
+    return position;
+}
+
+static uintptr_t sprint_snapshot_put_str_internal(char* blob, size_t* offset, const char* str)
+{
+    return str != NULL ? sprint_snapshot_put_internal(blob, offset, str, strlen(str) + 1) : 0;
+}
+
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "misc-no-recursion"
+static uintptr_t sprint_snapshot_copy_internal(char* blob, size_t* offset, sprint_element* elements, int count)
+{
+    // Copy the elements, whose pointers are still the original ones
+    uintptr_t position = sprint_snapshot_put_internal(blob, offset, elements, count * sizeof(sprint_element));
+    if (position == 0) return 0;
+
+    // Then copy everything they reference behind them
+    sprint_element* copies = (sprint_element*) (blob + position);
+    for (int index = 0; index < count; index++)
+        sprint_snapshot_relocate_internal(blob, offset, &copies[index]);
+    return position;
+}
+
+static void sprint_snapshot_relocate_internal(char* blob, size_t* offset, sprint_element* copy)
+{
+    // Copy everything the element references, replacing the pointers with the offsets of the copies
+    switch (copy->type) {
+        case SPRINT_ELEMENT_TRACK:
+            copy->track.points = (sprint_tuple*) sprint_snapshot_put_internal(
+                    blob, offset, copy->track.points, copy->track.num_points * sizeof(*copy->track.points));
+            copy->track.name = (char*) sprint_snapshot_put_str_internal(blob, offset, copy->track.name);
+            break;
+        case SPRINT_ELEMENT_PAD_THT:
+            copy->pad_tht.link.connections = (int*) sprint_snapshot_put_internal(
+                    blob, offset, copy->pad_tht.link.connections, copy->pad_tht.link.num_connections * sizeof(int));
+            copy->pad_tht.name = (char*) sprint_snapshot_put_str_internal(blob, offset, copy->pad_tht.name);
+            break;
+        case SPRINT_ELEMENT_PAD_SMT:
+            copy->pad_smt.link.connections = (int*) sprint_snapshot_put_internal(
+                    blob, offset, copy->pad_smt.link.connections, copy->pad_smt.link.num_connections * sizeof(int));
+            copy->pad_smt.name = (char*) sprint_snapshot_put_str_internal(blob, offset, copy->pad_smt.name);
+            break;
+        case SPRINT_ELEMENT_ZONE:
+            copy->zone.points = (sprint_tuple*) sprint_snapshot_put_internal(
+                    blob, offset, copy->zone.points, copy->zone.num_points * sizeof(*copy->zone.points));
+            copy->zone.name = (char*) sprint_snapshot_put_str_internal(blob, offset, copy->zone.name);
+            break;
+        case SPRINT_ELEMENT_TEXT:
+            copy->text.text = (char*) sprint_snapshot_put_str_internal(blob, offset, copy->text.text);
+            copy->text.name = (char*) sprint_snapshot_put_str_internal(blob, offset, copy->text.name);
+            break;
+        case SPRINT_ELEMENT_CIRCLE:
+            copy->circle.name = (char*) sprint_snapshot_put_str_internal(blob, offset, copy->circle.name);
+            break;
+        case SPRINT_ELEMENT_COMPONENT:
+            copy->component.text_id = (sprint_element*) sprint_snapshot_copy_internal(
+                    blob, offset, copy->component.text_id, 1);
+            copy->component.text_value = (sprint_element*) sprint_snapshot_copy_internal(
+                    blob, offset, copy->component.text_value, 1);
+            copy->component.elements = (sprint_element*) sprint_snapshot_copy_internal(
+                    blob, offset, copy->component.elements, copy->component.num_elements);
+            copy->component.comment = (char*) sprint_snapshot_put_str_internal(blob, offset, copy->component.comment);
+            copy->component.package = (char*) sprint_snapshot_put_str_internal(blob, offset, copy->component.package);
+            break;
+        case SPRINT_ELEMENT_GROUP:
+            copy->group.elements = (sprint_element*) sprint_snapshot_copy_internal(
+                    blob, offset, copy->group.elements, copy->group.num_elements);
+            break;
+    }
+}
+#pragma clang diagnostic pop
+
+static bool sprint_snapshot_fixup_internal(char* blob, size_t length, void** pointer, size_t size, bool required)
+{
+    // Offset zero stands for a null pointer, otherwise the referenced memory must be inside the snapshot
+    uintptr_t offset = (uintptr_t) *pointer;
+    if (offset == 0)
+        return !required;
+    if (offset < sizeof(sprint_snapshot_header) || offset > length || size > length - offset)
+        return false;
+
+    *pointer = blob + offset;
+    return true;
+}
+
+static bool sprint_snapshot_fixup_str_internal(char* blob, size_t length, char** str)
+{
+    // Strings must be terminated inside the snapshot
+    if (!sprint_snapshot_fixup_internal(blob, length, (void**) str, 1, false))
+        return false;
+    return *str == NULL || memchr(*str, 0, length - (*str - blob)) != NULL;
+}
+
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "misc-no-recursion"
+static bool sprint_snapshot_fixup_elements_internal(char* blob, size_t length, sprint_element* elements, int count,
+                                                    int depth)
+{
+    if (depth > SPRINT_ELEMENT_DEPTH || count < 0) return false;
+
+    for (int index = 0; index < count; index++) {
+        sprint_element* element = &elements[index];
+
+        // The elements are parsed ones, whose memory is owned by the arena of the board
+        element->parsed = true;
+        element->pooled = true;
+
+        bool valid;
+        switch (element->type) {
+            case SPRINT_ELEMENT_TRACK:
+                valid = element->track.num_points >= 0 &&
+                        sprint_snapshot_fixup_internal(blob, length, (void**) &element->track.points,
+                                                       element->track.num_points * sizeof(*element->track.points), false) &&
+                        sprint_snapshot_fixup_str_internal(blob, length, &element->track.name);
+                break;
+            case SPRINT_ELEMENT_PAD_THT:
+                valid = element->pad_tht.link.num_connections >= 0 &&
+                        sprint_snapshot_fixup_internal(blob, length, (void**) &element->pad_tht.link.connections,
+                                                       element->pad_tht.link.num_connections * sizeof(int), false) &&
+                        sprint_snapshot_fixup_str_internal(blob, length, &element->pad_tht.name);
+                break;
+            case SPRINT_ELEMENT_PAD_SMT:
+                valid = element->pad_smt.link.num_connections >= 0 &&
+                        sprint_snapshot_fixup_internal(blob, length, (void**) &element->pad_smt.link.connections,
+                                                       element->pad_smt.link.num_connections * sizeof(int), false) &&
+                        sprint_snapshot_fixup_str_internal(blob, length, &element->pad_smt.name);
+                break;
+            case SPRINT_ELEMENT_ZONE:
+                valid = element->zone.num_points >= 0 &&
+                        sprint_snapshot_fixup_internal(blob, length, (void**) &element->zone.points,
+                                                       element->zone.num_points * sizeof(*element->zone.points), false) &&
+                        sprint_snapshot_fixup_str_internal(blob, length, &element->zone.name);
+                break;
+            case SPRINT_ELEMENT_TEXT:
+                valid = sprint_snapshot_fixup_str_internal(blob, length, &element->text.text) &&
+                        sprint_snapshot_fixup_str_internal(blob, length, &element->text.name);
+                break;
+            case SPRINT_ELEMENT_CIRCLE:
+                valid = sprint_snapshot_fixup_str_internal(blob, length, &element->circle.name);
+                break;
+            case SPRINT_ELEMENT_COMPONENT:
+                valid = element->component.num_elements >= 0 &&
+                        sprint_snapshot_fixup_internal(blob, length, (void**) &element->component.text_id,
+                                                       sizeof(sprint_element), true) &&
+                        sprint_snapshot_fixup_internal(blob, length, (void**) &element->component.text_value,
+                                                       sizeof(sprint_element), true) &&
+                        sprint_snapshot_fixup_internal(blob, length, (void**) &element->component.elements,
+                                                       element->component.num_elements * sizeof(sprint_element), false) &&
+                        sprint_snapshot_fixup_str_internal(blob, length, &element->component.comment) &&
+                        sprint_snapshot_fixup_str_internal(blob, length, &element->component.package) &&
+                        sprint_snapshot_fixup_elements_internal(blob, length, element->component.text_id, 1, depth + 1) &&
+                        sprint_snapshot_fixup_elements_internal(blob, length, element->component.text_value, 1, depth + 1) &&
+                        sprint_snapshot_fixup_elements_internal(blob, length, element->component.elements,
+                                                                element->component.num_elements, depth + 1);
+                break;
+            case SPRINT_ELEMENT_GROUP:
+                valid = element->group.num_elements >= 0 &&
+                        sprint_snapshot_fixup_internal(blob, length, (void**) &element->group.elements,
+                                                       element->group.num_elements * sizeof(sprint_element), false) &&
+                        sprint_snapshot_fixup_elements_internal(blob, length, element->group.elements,
+                                                                element->group.num_elements, depth + 1);
+                break;
+            default:
+                return false;
+        }
+
+        // Finally, the element must be as valid as a parsed one
+        if (!valid || !sprint_element_valid(element))
+            return false;
+    }
+    return true;
+}
+#pragma clang diagnostic pop
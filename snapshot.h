@@ -0,0 +1,91 @@
+//
+// SprintTrace: binary board snapshots
+// Copyright 2022, Laminoid.com (Muessig & Muessig GbR).
+// Licensed under the terms and conditions of the GPLv3.
+//
+
+#ifndef SPRINTTRACE_SNAPSHOT_H
+#define SPRINTTRACE_SNAPSHOT_H
+
+#include "pcb.h"
+#include "token.h"
+#include "errors.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+extern const char SPRINT_SNAPSHOT_MAGIC[8];
+extern const uint32_t SPRINT_SNAPSHOT_VERSION;
+extern const char* SPRINT_SNAPSHOT_CACHE_VARIABLE;
+extern const char* SPRINT_SNAPSHOT_PREFIX;
+extern const char* SPRINT_SNAPSHOT_SUFFIX;
+extern const char* SPRINT_SNAPSHOT_DIRECTORY;
+extern const int SPRINT_SNAPSHOT_CACHE_LIMIT;
+
+// Identifies the input that a snapshot has been taken of
+typedef struct sprint_snapshot_key {
+    uint64_t hash;
+    uint64_t size;
+} sprint_snapshot_key;
+
+// Precedes the elements of a snapshot, whose pointers are stored as offsets from the start of the header
+typedef struct sprint_snapshot_header {
+    // Identifies snapshots of this format and version, which must match exactly
+    char magic[8];
+    uint32_t version;
+
+    // The sizes of the structures in memory, which must match the ones of the reading build
+    uint16_t element_size;
+    uint16_t pointer_size;
+
+    // The input that the snapshot has been taken of
+    sprint_snapshot_key key;
+
+    // The size of the entire snapshot, including this header
+    uint64_t length;
+
+    // The number of top-level elements, which follow this header
+    int32_t num_elements;
+} sprint_snapshot_header;
+
+/**
+ * Hashes the entire input of a tokenizer, which must be persistent.
+ * @param tokenizer The tokenizer of the input, regardless of how far it has been read.
+ * @param key The target reference to write the key of the input to.
+ * @return No error returned on success. If the input is not persistent, returns invalid state.
+ */
+sprint_error sprint_snapshot_key_of(sprint_tokenizer* tokenizer, sprint_snapshot_key* key);
+/**
+ * Determines the path of the snapshot of an input inside the cache directory.
+ * The directory is taken from the environment variable SPRINT_SNAPSHOT_CACHE_VARIABLE. Otherwise, it is
+ * SPRINT_SNAPSHOT_DIRECTORY inside the cache directory of the user, which is created if needed:
+ * $XDG_CACHE_HOME or ~/.cache on POSIX systems, and %LOCALAPPDATA% on Windows.
+ * On POSIX systems, the directory must belong to the user and must not be writable by anyone else.
+ * @param key The key of the input.
+ * @param path The target reference to write the allocated path to.
+ * @return No error returned on success. If caching is turned off by setting the variable empty, if there is no
+ *         cache directory of the user or if the directory is not private, returns invalid state.
+ */
+sprint_error sprint_snapshot_path(sprint_snapshot_key key, char** path);
+/**
+ * Loads the elements of a board from a snapshot using a single read, after which only the pointers are fixed up.
+ * The elements are allocated from the arena of the board, which must exist.
+ * @param pcb The board to load the elements into, which must not have any yet.
+ * @param key The key of the input that the snapshot must have been taken of.
+ * @param path The path of the snapshot.
+ * @return No error returned on success. If the snapshot cannot be read, returns IO. If it is of another input,
+ *         version or build, returns invalid state. If it is damaged, returns argument format.
+ */
+sprint_error sprint_snapshot_read(sprint_pcb* pcb, sprint_snapshot_key key, const char* path);
+/**
+ * Writes the elements of a board to a snapshot, which replaces an existing one at once.
+ * Afterwards, only the SPRINT_SNAPSHOT_CACHE_LIMIT most recently used snapshots of its directory are kept.
+ * @param pcb The board to take the snapshot of.
+ * @param key The key of the input that the board has been parsed from.
+ * @param path The path of the snapshot.
+ * @return No error returned on success.
+ */
+sprint_error sprint_snapshot_write(sprint_pcb* pcb, sprint_snapshot_key key, const char* path);
+
+#endif //SPRINTTRACE_SNAPSHOT_H
@@ -0,0 +1,172 @@
+//
+// SprintTrace: segmented element storage
+// Copyright 2022, Laminoid.com (Muessig & Muessig GbR).
+// Licensed under the terms and conditions of the GPLv3.
+//
+
+#include "storage.h"
+#include "elements.h"
+#include "errors.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+const int SPRINT_STORAGE_BLOCK_SIZE = 256;
+
+static sprint_error sprint_storage_reserve_internal(sprint_storage* storage, int count);
+
+sprint_error sprint_storage_push(sprint_storage* storage, sprint_element** element)
+{
+    if (storage == NULL || element == NULL) return SPRINT_ERROR_ARGUMENT_NULL;
+    if (storage->count == INT_MAX) return SPRINT_ERROR_OVERFLOW;
+
+    // Make sure that there is a block for the new element
+    sprint_error error = sprint_storage_reserve_internal(storage, storage->count + 1);
+    if (error != SPRINT_ERROR_NONE)
+        return sprint_rethrow(error);
+
+    // Hand out the slot at the end of the last block and increment the count
+    int index = storage->count++;
+    *element = &storage->blocks[index / SPRINT_STORAGE_BLOCK_SIZE][index % SPRINT_STORAGE_BLOCK_SIZE];
+    return SPRINT_ERROR_NONE;
+}
+
+sprint_error sprint_storage_add_all(sprint_storage* storage, const sprint_element* elements, int count)
+{
+    if (storage == NULL || (elements == NULL && count > 0)) return SPRINT_ERROR_ARGUMENT_NULL;
+    if (count < 0) return SPRINT_ERROR_ARGUMENT_RANGE;
+    if (count > INT_MAX - storage->count) return SPRINT_ERROR_OVERFLOW;
+
+    // Allocate all blocks at once
+    sprint_error error = sprint_storage_reserve_internal(storage, storage->count + count);
+    if (error != SPRINT_ERROR_NONE)
+        return sprint_rethrow(error);
+
+    // Then fill them one after another
+    while (count > 0) {
+        int offset = storage->count % SPRINT_STORAGE_BLOCK_SIZE;
+        int chunk = SPRINT_STORAGE_BLOCK_SIZE - offset;
+        if (chunk > count)
+            chunk = count;
+        memcpy(&storage->blocks[storage->count / SPRINT_STORAGE_BLOCK_SIZE][offset], elements,
+               chunk * sizeof(sprint_element));
+        storage->count += chunk;
+        elements += chunk;
+        count -= chunk;
+    }
+    return SPRINT_ERROR_NONE;
+}
+
+sprint_error sprint_storage_append(sprint_storage* storage, sprint_storage* source)
+{
+    if (storage == NULL || source == NULL) return SPRINT_ERROR_ARGUMENT_NULL;
+    if (storage == source) return SPRINT_ERROR_ARGUMENT_RANGE;
+    if (source->count > INT_MAX - storage->count) return SPRINT_ERROR_OVERFLOW;
+
+    // Allocate all blocks at once, so that either all elements are added or none
+    sprint_error error = sprint_storage_reserve_internal(storage, storage->count + source->count);
+    if (error != SPRINT_ERROR_NONE)
+        return sprint_rethrow(error);
+
+    // Then copy the blocks of the source, the last of which may only be filled partially
+    for (int index = 0; index < source->count; index += SPRINT_STORAGE_BLOCK_SIZE) {
+        int count = source->count - index;
+        if (count > SPRINT_STORAGE_BLOCK_SIZE)
+            count = SPRINT_STORAGE_BLOCK_SIZE;
+        if (!sprint_chain(error, sprint_storage_add_all(storage, source->blocks[index / SPRINT_STORAGE_BLOCK_SIZE],
+                                                        count)))
+            break;
+    }
+    return sprint_rethrow(error);
+}
+
+sprint_element* sprint_storage_get(sprint_storage* storage, int index)
+{
+    if (storage == NULL || index < 0 || index >= storage->count) return NULL;
+    return &storage->blocks[index / SPRINT_STORAGE_BLOCK_SIZE][index % SPRINT_STORAGE_BLOCK_SIZE];
+}
+
+sprint_element* sprint_storage_remove(sprint_storage* storage)
+{
+    if (storage == NULL || storage->count < 1) return NULL;
+
+    int index = --storage->count;
+    return &storage->blocks[index / SPRINT_STORAGE_BLOCK_SIZE][index % SPRINT_STORAGE_BLOCK_SIZE];
+}
+
+sprint_error sprint_storage_destroy(sprint_storage* storage)
+{
+    if (storage == NULL) return SPRINT_ERROR_ARGUMENT_NULL;
+
+    for (int index = 0; index < storage->num_blocks; index++)
+        free(storage->blocks[index]);
+    free(storage->blocks);
+    memset(storage, 0, sizeof(*storage));
+    return SPRINT_ERROR_NONE;
+}
+
+sprint_error sprint_storage_begin(sprint_storage* storage, int start, int count, sprint_storage_iterator* iterator)
+{
+    if (storage == NULL || iterator == NULL) return SPRINT_ERROR_ARGUMENT_NULL;
+    if (start < 0 || count < 0 || start > storage->count || count > storage->count - start)
+        return SPRINT_ERROR_ARGUMENT_RANGE;
+
+    // The first block is only looked up once the first element is requested
+    iterator->storage = storage;
+    iterator->index = start;
+    iterator->end = start + count;
+    iterator->position = NULL;
+    iterator->limit = NULL;
+    return SPRINT_ERROR_NONE;
+}
+
+bool sprint_storage_next(sprint_storage_iterator* iterator, sprint_element** element)
+{
+    if (iterator == NULL || element == NULL) return false;
+
+    // Continue in the next block, once the current one has been visited entirely
+    if (iterator->position == iterator->limit) {
+        if (iterator->index >= iterator->end)
+            return false;
+        int offset = iterator->index % SPRINT_STORAGE_BLOCK_SIZE;
+        int count = SPRINT_STORAGE_BLOCK_SIZE - offset;
+        if (count > iterator->end - iterator->index)
+            count = iterator->end - iterator->index;
+        iterator->position = &iterator->storage->blocks[iterator->index / SPRINT_STORAGE_BLOCK_SIZE][offset];
+        iterator->limit = iterator->position + count;
+    }
+
+    *element = iterator->position++;
+    iterator->index++;
+    return true;
+}
+
+sprint_error sprint_storage_reserve_internal(sprint_storage* storage, int count)
+{
+    int num_blocks = count / SPRINT_STORAGE_BLOCK_SIZE + (count % SPRINT_STORAGE_BLOCK_SIZE != 0);
+    if (num_blocks <= storage->num_blocks)
+        return SPRINT_ERROR_NONE;
+
+    // Grow the table of blocks, doubling its capacity every time, which leaves the blocks themselves in place
+    if (num_blocks > storage->max_blocks) {
+        int max_blocks = storage->max_blocks > 0 ? storage->max_blocks : 8;
+        while (max_blocks < num_blocks)
+            max_blocks *= 2;
+        sprint_element** blocks = realloc(storage->blocks, max_blocks * sizeof(*blocks));
+        if (blocks == NULL)
+            return SPRINT_ERROR_MEMORY;
+        storage->blocks = blocks;
+        storage->max_blocks = max_blocks;
+    }
+
+    // Then allocate the missing blocks
+    while (storage->num_blocks < num_blocks) {
+        sprint_element* block = malloc(SPRINT_STORAGE_BLOCK_SIZE * sizeof(sprint_element));
+        if (block == NULL)
+            return SPRINT_ERROR_MEMORY;
+        storage->blocks[storage->num_blocks++] = block;
+    }
+    return SPRINT_ERROR_NONE;
+}
@@ -0,0 +1,96 @@
+//
+// SprintTrace: segmented element storage
+// Copyright 2022, Laminoid.com (Muessig & Muessig GbR).
+// Licensed under the terms and conditions of the GPLv3.
+//
+
+#ifndef SPRINTTRACE_STORAGE_H
+#define SPRINTTRACE_STORAGE_H
+
+#include "elements.h"
+#include "errors.h"
+
+#include <stdbool.h>
+
+extern const int SPRINT_STORAGE_BLOCK_SIZE;
+
+// Represents a growable sequence of elements, which are kept in fixed-size blocks so that they never move.
+// The storage is a plain value, which starts out empty when zero-initialized.
+typedef struct sprint_storage {
+    // The number of elements
+    int count;
+
+    // The blocks of SPRINT_STORAGE_BLOCK_SIZE elements each, which are filled in order,
+    // and the capacity of the table of blocks, which is the only thing that is moved when growing
+    int num_blocks;
+    int max_blocks;
+    sprint_element** blocks;
+} sprint_storage;
+
+// Walks a range of elements of a storage in order, one block after another
+typedef struct sprint_storage_iterator {
+    sprint_storage* storage;
+
+    // The index of the next element and the end of the range
+    int index;
+    int end;
+
+    // The next element and the end of its block, or of the range if that comes first
+    sprint_element* position;
+    sprint_element* limit;
+} sprint_storage_iterator;
+
+/**
+ * Adds an uninitialized element to the end of the storage, so that it can be written in place.
+ * @param storage The storage to add the element to.
+ * @param element The target reference to write the address of the element to.
+ *                It remains valid until the element is removed or the storage is destroyed.
+ * @return No error returned on success.
+ */
+sprint_error sprint_storage_push(sprint_storage* storage, sprint_element** element);
+/**
+ * Copies elements to the end of the storage, which only shallowly copies what they reference.
+ * @param storage The storage to add the elements to.
+ * @param elements The elements to copy.
+ * @param count The number of elements.
+ * @return No error returned on success.
+ */
+sprint_error sprint_storage_add_all(sprint_storage* storage, const sprint_element* elements, int count);
+/**
+ * Copies all elements of another storage to the end of the storage, like adding them one after another.
+ * @param storage The storage to add the elements to.
+ * @param source The storage to copy the elements from, which is left unchanged.
+ * @return No error returned on success.
+ */
+sprint_error sprint_storage_append(sprint_storage* storage, sprint_storage* source);
+sprint_element* sprint_storage_get(sprint_storage* storage, int index);
+/**
+ * Removes the last element of the storage, keeping its block for the next element to be added.
+ * @param storage The storage instance.
+ * @return The removed element, which remains valid until another one is added, or null if the storage is empty.
+ */
+sprint_element* sprint_storage_remove(sprint_storage* storage);
+/**
+ * Releases the blocks of the storage and leaves it empty, without destroying the contents of the elements.
+ * @param storage The storage instance.
+ * @return No error returned on success.
+ */
+sprint_error sprint_storage_destroy(sprint_storage* storage);
+/**
+ * Starts iterating over a range of elements of the storage.
+ * @param storage The storage instance.
+ * @param start The index of the first element to visit.
+ * @param count The number of elements to visit.
+ * @param iterator The iterator to initialize.
+ * @return No error returned on success. If the range is not inside the storage, returns argument range.
+ */
+sprint_error sprint_storage_begin(sprint_storage* storage, int start, int count, sprint_storage_iterator* iterator);
+/**
+ * Advances the iterator to the next element of its range.
+ * @param iterator The iterator instance.
+ * @param element The target reference to write the address of the element to.
+ * @return Whether there was another element.
+ */
+bool sprint_storage_next(sprint_storage_iterator* iterator, sprint_element** element);
+
+#endif //SPRINTTRACE_STORAGE_H
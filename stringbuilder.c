@@ -17,6 +17,16 @@
 #include <limits.h>
 #endif
 
+// All pairs of decimal digits, which allows converting two digits at once
+static const char SPRINT_STRINGBUILDER_DIGIT_PAIRS[] =
+        "0001020304050607080910111213141516171819"
+        "2021222324252627282930313233343536373839"
+        "4041424344454647484950515253545556575859"
+        "6061626364656667686970717273747576777879"
+        "8081828384858687888990919293949596979899";
+
+static int sprint_stringbuilder_format_uint_internal(char* destination, unsigned int num);
+
 sprint_stringbuilder* sprint_stringbuilder_create(int capacity)
 {
     if (capacity < 0) return NULL;
@@ -29,6 +39,21 @@ sprint_stringbuilder* sprint_stringbuilder_create(int capacity)
     return builder;
 }
 
+sprint_stringbuilder* sprint_stringbuilder_create_inline(int capacity)
+{
+    if (capacity < 0) return NULL;
+
+    // Allocate the string builder together with its characters, which follow it
+    sprint_stringbuilder* builder = calloc(1, sizeof(*builder) + capacity * sizeof(char) + 1);
+    if (builder == NULL)
+        return NULL;
+    builder->capacity = capacity;
+    builder->content = (char*) (builder + 1);
+    builder->inlined = true;
+
+    return builder;
+}
+
 sprint_stringbuilder* sprint_stringbuilder_of(const char* content)
 {
     if (content == NULL) return NULL;
@@ -51,9 +76,10 @@ sprint_error sprint_stringbuilder_destroy(sprint_stringbuilder* builder)
     builder->count = 0;
     builder->capacity = 0;
 
-    // If required, free the content
+    // If required, free the content, unless it is stored inline
     if (builder->content != NULL) {
-        free(builder->content);
+        if (!builder->inlined)
+            free(builder->content);
         builder->content = NULL;
     }
 
@@ -64,6 +90,17 @@ sprint_error sprint_stringbuilder_destroy(sprint_stringbuilder* builder)
 
 char* sprint_stringbuilder_complete(sprint_stringbuilder* builder)
 {
+    // Inline content is freed together with the builder, so copy it out
+    if (builder != NULL && builder->inlined) {
+        char* result = malloc(builder->count * sizeof(char) + 1);
+        if (result != NULL) {
+            memcpy(result, builder->content, builder->count * sizeof(char));
+            result[builder->count] = 0;
+        }
+        free(builder);
+        return result;
+    }
+
     if (!sprint_check(sprint_stringbuilder_trim(builder))) {
         free(builder);
         return NULL;
@@ -221,10 +258,9 @@ sprint_error sprint_stringbuilder_put_str_range(sprint_stringbuilder* builder, c
     if (limit < 0) return SPRINT_ERROR_ARGUMENT_RANGE;
     if (builder->content == NULL) return SPRINT_ERROR_STATE_INVALID;
 
-    // Ensure that there is room to put the string
-    int additional_length = (int) strlen(str);
-    if (additional_length > limit)
-        additional_length = limit;
+    // Ensure that there is room to put the string, without looking beyond the limit for its end
+    const char* str_end = memchr(str, 0, limit);
+    int additional_length = str_end == NULL ? limit : (int) (str_end - str);
     int minimum_capacity = builder->count + additional_length;
     if (builder->content == NULL || minimum_capacity >= builder->capacity)
     {
@@ -239,10 +275,31 @@ sprint_error sprint_stringbuilder_put_str_range(sprint_stringbuilder* builder, c
     return SPRINT_ERROR_NONE;
 }
 
+sprint_error sprint_stringbuilder_put_bytes(sprint_stringbuilder* builder, const char* bytes, int length)
+{
+    if (builder == NULL || bytes == NULL) return SPRINT_ERROR_ARGUMENT_NULL;
+    if (length < 0) return SPRINT_ERROR_ARGUMENT_RANGE;
+
+    // Ensure that there is room to put the characters
+    int minimum_capacity = builder->count + length;
+    if (builder->content == NULL || minimum_capacity >= builder->capacity)
+    {
+        sprint_error error = sprint_stringbuilder_grow(builder, builder->capacity * 2 + minimum_capacity);
+        if (error != SPRINT_ERROR_NONE)
+            return sprint_rethrow(error);
+    }
+
+    // Copy the characters
+    memcpy(builder->content + builder->count, bytes, length * sizeof(char));
+    builder->count += length;
+    return SPRINT_ERROR_NONE;
+}
+
 sprint_error sprint_stringbuilder_put_int(sprint_stringbuilder* builder, int num)
 {
-    // Using the formatter is the safest option to print a decimal integer
-    return sprint_stringbuilder_format(builder, "%d", num);
+    char digits[11];
+    int length = sprint_stringbuilder_format_int(digits, num);
+    return sprint_stringbuilder_put_str_range(builder, digits, length);
 }
 
 sprint_error sprint_stringbuilder_put_hex(sprint_stringbuilder* builder, int num)
@@ -311,6 +368,17 @@ sprint_error sprint_stringbuilder_grow(sprint_stringbuilder* builder, int capaci
     // If the builder is already big enough, do nothing
     if (builder->capacity >= capacity) return SPRINT_ERROR_NONE;
 
+    // Inline content cannot be reallocated, so move it to the heap instead
+    if (builder->inlined) {
+        char* new_content = malloc(capacity * sizeof(char) + 1);
+        if (new_content == NULL) return SPRINT_ERROR_MEMORY;
+        memcpy(new_content, builder->content, builder->count * sizeof(char));
+        builder->capacity = capacity;
+        builder->content = new_content;
+        builder->inlined = false;
+        return SPRINT_ERROR_NONE;
+    }
+
     // Grow the builder to the new capacity
     void* new_content = realloc(builder->content, capacity * sizeof(char) + 1);
     if (new_content == NULL) return SPRINT_ERROR_MEMORY;
@@ -333,8 +401,8 @@ sprint_error sprint_stringbuilder_trim(sprint_stringbuilder* builder)
         return builder->content == NULL ? SPRINT_ERROR_MEMORY : SPRINT_ERROR_NONE;
     }
 
-    // Only do something, if the count doesn't already match the capacity
-    if (builder->count == builder->capacity) return SPRINT_ERROR_NONE;
+    // Only do something, if the count doesn't already match the capacity and the content can be reallocated
+    if (builder->count == builder->capacity || builder->inlined) return SPRINT_ERROR_NONE;
 
     // Shrink the builder to the count
     char* new_content = realloc(builder->content, builder->count * sizeof(char) + 1);
@@ -345,3 +413,52 @@ sprint_error sprint_stringbuilder_trim(sprint_stringbuilder* builder)
     builder->content = new_content;
     return SPRINT_ERROR_NONE;
 }
+
+int sprint_stringbuilder_format_int(char* destination, int num)
+{
+    if (num >= 0)
+        return sprint_stringbuilder_format_uint_internal(destination, num);
+
+    // Negate without overflowing, which also works for the smallest integer
+    *destination = '-';
+    return 1 + sprint_stringbuilder_format_uint_internal(destination + 1, 0u - (unsigned int) num);
+}
+
+int sprint_stringbuilder_format_fixed(char* destination, int whole, int fraction, int precision)
+{
+    // Put the integer part and the decimal point
+    int length = sprint_stringbuilder_format_int(destination, whole);
+    destination[length++] = '.';
+
+    // Then put the fractional part, padded with zeros to the precision
+    char digits[11];
+    int count = sprint_stringbuilder_format_uint_internal(digits, fraction);
+    for (; precision > count; precision--)
+        destination[length++] = '0';
+    memcpy(destination + length, digits, count);
+    return length + count;
+}
+
+int sprint_stringbuilder_format_uint_internal(char* destination, unsigned int num)
+{
+    // Convert the digits from the back, two at a time
+    char digits[11];
+    int position = sizeof(digits);
+    while (num >= 100) {
+        const char* pair = &SPRINT_STRINGBUILDER_DIGIT_PAIRS[num % 100 * 2];
+        num /= 100;
+        digits[--position] = pair[1];
+        digits[--position] = pair[0];
+    }
+    if (num >= 10) {
+        const char* pair = &SPRINT_STRINGBUILDER_DIGIT_PAIRS[num * 2];
+        digits[--position] = pair[1];
+        digits[--position] = pair[0];
+    } else
+        digits[--position] = (char) ('0' + num);
+
+    // Then move them to the front
+    int length = (int) sizeof(digits) - position;
+    memcpy(destination, digits + position, length);
+    return length;
+}
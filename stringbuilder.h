@@ -23,9 +23,19 @@ typedef struct sprint_stringbuilder {
 
     // The pointer to the characters in this builder
     char* content;
+
+    // Whether the characters are stored inline after this builder, until they outgrow the initial capacity
+    bool inlined;
 } sprint_stringbuilder;
 
 sprint_stringbuilder* sprint_stringbuilder_create(int capacity);
+/**
+ * Creates a string builder that stores its characters inside the same allocation, until they outgrow the capacity.
+ * Short contents thus never need another allocation, while longer ones move to the heap as usual.
+ * @param capacity The number of characters to store inline.
+ * @return The builder, or null if it could not be allocated.
+ */
+sprint_stringbuilder* sprint_stringbuilder_create_inline(int capacity);
 sprint_stringbuilder* sprint_stringbuilder_of(const char* content);
 sprint_error sprint_stringbuilder_destroy(sprint_stringbuilder* builder);
 char* sprint_stringbuilder_complete(sprint_stringbuilder* builder);
@@ -41,6 +51,14 @@ sprint_error sprint_stringbuilder_put_range(sprint_stringbuilder* builder, sprin
 sprint_error sprint_stringbuilder_put_chr(sprint_stringbuilder* builder, char chr);
 sprint_error sprint_stringbuilder_put_str(sprint_stringbuilder* builder, const char* str);
 sprint_error sprint_stringbuilder_put_str_range(sprint_stringbuilder* builder, const char* str, int limit);
+/**
+ * Puts a range of characters at once, which need not be terminated and are copied as they are.
+ * @param builder The builder instance.
+ * @param bytes The characters to put.
+ * @param length The number of characters to put.
+ * @return No error returned on success.
+ */
+sprint_error sprint_stringbuilder_put_bytes(sprint_stringbuilder* builder, const char* bytes, int length);
 sprint_error sprint_stringbuilder_put_int(sprint_stringbuilder* builder, int num);
 sprint_error sprint_stringbuilder_put_hex(sprint_stringbuilder* builder, int num);
 char* sprint_stringbuilder_substr(sprint_stringbuilder* builder, int start, int length);
@@ -50,5 +68,22 @@ sprint_error sprint_stringbuilder_remove_end(sprint_stringbuilder* builder, int
 sprint_error sprint_stringbuilder_clear(sprint_stringbuilder* builder);
 sprint_error sprint_stringbuilder_grow(sprint_stringbuilder* builder, int capacity);
 sprint_error sprint_stringbuilder_trim(sprint_stringbuilder* builder);
+/**
+ * Formats a decimal integer exactly like "%d" would, without going through the formatter.
+ * @param destination The buffer to write to, which must have room for 11 characters.
+ * @param num The integer to format.
+ * @return The number of characters written, which are not terminated.
+ */
+int sprint_stringbuilder_format_int(char* destination, int num);
+/**
+ * Formats a fixed-point number exactly like "%d.%0*d" would, without going through the formatter.
+ * @param destination The buffer to write to, which must have room for 12 characters more than the greater of
+ *                    the precision and 10.
+ * @param whole The integer part.
+ * @param fraction The fractional part, which must not be negative.
+ * @param precision The minimum number of fractional digits.
+ * @return The number of characters written, which are not terminated.
+ */
+int sprint_stringbuilder_format_fixed(char* destination, int whole, int fraction, int precision);
 
 #endif //SPRINTTRACE_STRINGBUILDER_H
@@ -11,7 +11,22 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <errno.h>
+#include <limits.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 
 const char* SPRINT_TOKENIZER_STATE_NAMES[] = {
         [SPRINT_TOKENIZER_STATE_SCANNING] = "scanning",
@@ -48,12 +63,151 @@ const char SPRINT_TUPLE_SEPARATOR = '/';
 const char SPRINT_STRING_DELIMITER = '|';
 const char* SPRINT_TRUE_VALUE = "true";
 const char* SPRINT_FALSE_VALUE = "false";
+const int SPRINT_TOKENIZER_BLOCK_SIZE = 64 * 1024;
 
 static void sprint_tokenizer_count_internal(sprint_tokenizer* tokenizer, char chr);
+static void sprint_tokenizer_count_run_internal(sprint_tokenizer* tokenizer, int count);
+static void sprint_tokenizer_origin_internal(sprint_tokenizer* tokenizer, sprint_source_origin* origin);
+static sprint_error sprint_tokenizer_index_internal(sprint_tokenizer* tokenizer);
+static const char* sprint_tokenizer_skip_internal(const char* start, const char* end, sprint_tokenizer_state state);
+static sprint_error sprint_tokenizer_scan_block_internal(sprint_tokenizer* tokenizer, sprint_token* token,
+                                                         sprint_stringbuilder* builder, bool* scanning, bool* complete);
+static bool sprint_tokenizer_read_block_internal(sprint_tokenizer* tokenizer);
 static bool sprint_tokenizer_read_str_internal(sprint_tokenizer* tokenizer);
 static bool sprint_tokenizer_read_file_internal(sprint_tokenizer* tokenizer);
+static bool sprint_tokenizer_read_mmap_internal(sprint_tokenizer* tokenizer);
+static bool sprint_tokenizer_read_range_internal(sprint_tokenizer* tokenizer);
+static bool sprint_tokenizer_read_feed_internal(sprint_tokenizer* tokenizer);
 static bool sprint_tokenizer_close_str_internal(sprint_tokenizer* tokenizer);
 static bool sprint_tokenizer_close_file_internal(sprint_tokenizer* tokenizer);
+static bool sprint_tokenizer_close_mmap_internal(sprint_tokenizer* tokenizer);
+
+// Determines the next state for a character at compile time, which must be kept in sync with the separator constants
+#define SPRINT_TOKENIZER_TRANSITION(state, chr) ( \
+    (state) == SPRINT_TOKENIZER_STATE_STRING_START || (state) == SPRINT_TOKENIZER_STATE_STRING ? \
+        ((chr) == '|' || (chr) == '\n' || (chr) == '\r' ? \
+            SPRINT_TOKENIZER_STATE_STRING_END : SPRINT_TOKENIZER_STATE_STRING) : \
+    ((state) == SPRINT_TOKENIZER_STATE_COMMENT && (chr) != '\n' && (chr) != '\r') || (chr) == '#' ? \
+        SPRINT_TOKENIZER_STATE_COMMENT : \
+    (chr) == ' ' || (chr) == '\t' || (chr) == '\n' || (chr) == '\r' ? \
+        SPRINT_TOKENIZER_STATE_SCANNING : \
+    ((chr) >= 'A' && (chr) <= 'Z') || ((chr) >= 'a' && (chr) <= 'z') || (chr) == '_' ? \
+        SPRINT_TOKENIZER_STATE_WORD : \
+    ((chr) >= '0' && (chr) <= '9') || ((chr) == '-' && (state) != SPRINT_TOKENIZER_STATE_NUMBER && \
+                                       (state) != SPRINT_TOKENIZER_STATE_WORD) ? \
+        SPRINT_TOKENIZER_STATE_NUMBER : \
+    (chr) == '=' ? SPRINT_TOKENIZER_STATE_VALUE_SEPARATOR : \
+    (chr) == '/' ? SPRINT_TOKENIZER_STATE_TUPLE_SEPARATOR : \
+    (chr) == ',' ? SPRINT_TOKENIZER_STATE_STATEMENT_SEPARATOR : \
+    (chr) == ';' ? SPRINT_TOKENIZER_STATE_STATEMENT_TERMINATOR : \
+    (chr) == '|' ? SPRINT_TOKENIZER_STATE_STRING_START : \
+        SPRINT_TOKENIZER_STATE_INVALID)
+#define SPRINT_TOKENIZER_TRANSITIONS_4(state, chr) \
+    SPRINT_TOKENIZER_TRANSITION(state, (chr)), SPRINT_TOKENIZER_TRANSITION(state, (chr) + 1), \
+    SPRINT_TOKENIZER_TRANSITION(state, (chr) + 2), SPRINT_TOKENIZER_TRANSITION(state, (chr) + 3)
+#define SPRINT_TOKENIZER_TRANSITIONS_16(state, chr) \
+    SPRINT_TOKENIZER_TRANSITIONS_4(state, (chr)), SPRINT_TOKENIZER_TRANSITIONS_4(state, (chr) + 4), \
+    SPRINT_TOKENIZER_TRANSITIONS_4(state, (chr) + 8), SPRINT_TOKENIZER_TRANSITIONS_4(state, (chr) + 12)
+#define SPRINT_TOKENIZER_TRANSITIONS_64(state, chr) \
+    SPRINT_TOKENIZER_TRANSITIONS_16(state, (chr)), SPRINT_TOKENIZER_TRANSITIONS_16(state, (chr) + 16), \
+    SPRINT_TOKENIZER_TRANSITIONS_16(state, (chr) + 32), SPRINT_TOKENIZER_TRANSITIONS_16(state, (chr) + 48)
+#define SPRINT_TOKENIZER_TRANSITIONS(state) [state] = { \
+    SPRINT_TOKENIZER_TRANSITIONS_64(state, 0), SPRINT_TOKENIZER_TRANSITIONS_64(state, 64), \
+    SPRINT_TOKENIZER_TRANSITIONS_64(state, 128), SPRINT_TOKENIZER_TRANSITIONS_64(state, 192)}
+
+// The next state for every state and character, indexed by the unsigned character
+static const unsigned char SPRINT_TOKENIZER_STATE_TRANSITIONS[][256] = {
+        SPRINT_TOKENIZER_TRANSITIONS(SPRINT_TOKENIZER_STATE_SCANNING),
+        SPRINT_TOKENIZER_TRANSITIONS(SPRINT_TOKENIZER_STATE_INVALID),
+        SPRINT_TOKENIZER_TRANSITIONS(SPRINT_TOKENIZER_STATE_COMMENT),
+        SPRINT_TOKENIZER_TRANSITIONS(SPRINT_TOKENIZER_STATE_WORD),
+        SPRINT_TOKENIZER_TRANSITIONS(SPRINT_TOKENIZER_STATE_NUMBER),
+        SPRINT_TOKENIZER_TRANSITIONS(SPRINT_TOKENIZER_STATE_STRING_START),
+        SPRINT_TOKENIZER_TRANSITIONS(SPRINT_TOKENIZER_STATE_STRING),
+        SPRINT_TOKENIZER_TRANSITIONS(SPRINT_TOKENIZER_STATE_STRING_END),
+        SPRINT_TOKENIZER_TRANSITIONS(SPRINT_TOKENIZER_STATE_VALUE_SEPARATOR),
+        SPRINT_TOKENIZER_TRANSITIONS(SPRINT_TOKENIZER_STATE_TUPLE_SEPARATOR),
+        SPRINT_TOKENIZER_TRANSITIONS(SPRINT_TOKENIZER_STATE_STATEMENT_SEPARATOR),
+        SPRINT_TOKENIZER_TRANSITIONS(SPRINT_TOKENIZER_STATE_STATEMENT_TERMINATOR)
+};
+
+// The bit set of states whose characters are recorded
+static const unsigned SPRINT_TOKENIZER_STATES_RECORDED =
+        1 << SPRINT_TOKENIZER_STATE_INVALID |
+        1 << SPRINT_TOKENIZER_STATE_WORD |
+        1 << SPRINT_TOKENIZER_STATE_NUMBER |
+        1 << SPRINT_TOKENIZER_STATE_STRING |
+        1 << SPRINT_TOKENIZER_STATE_VALUE_SEPARATOR |
+        1 << SPRINT_TOKENIZER_STATE_TUPLE_SEPARATOR |
+        1 << SPRINT_TOKENIZER_STATE_STATEMENT_SEPARATOR |
+        1 << SPRINT_TOKENIZER_STATE_STATEMENT_TERMINATOR;
+
+// The bit set of next states that complete the token for every current state
+static const unsigned SPRINT_TOKENIZER_STATE_COMPLETIONS[] = {
+        [SPRINT_TOKENIZER_STATE_SCANNING] = 0,
+        [SPRINT_TOKENIZER_STATE_INVALID] = ~0u,
+        [SPRINT_TOKENIZER_STATE_COMMENT] = 0,
+        [SPRINT_TOKENIZER_STATE_WORD] = ~(1u << SPRINT_TOKENIZER_STATE_WORD),
+        [SPRINT_TOKENIZER_STATE_NUMBER] = ~(1u << SPRINT_TOKENIZER_STATE_NUMBER),
+        [SPRINT_TOKENIZER_STATE_STRING_START] = 0,
+        [SPRINT_TOKENIZER_STATE_STRING] = 0,
+        [SPRINT_TOKENIZER_STATE_STRING_END] = ~(1u << SPRINT_TOKENIZER_STATE_STRING_END),
+        [SPRINT_TOKENIZER_STATE_VALUE_SEPARATOR] = ~0u,
+        [SPRINT_TOKENIZER_STATE_TUPLE_SEPARATOR] = ~0u,
+        [SPRINT_TOKENIZER_STATE_STATEMENT_SEPARATOR] = ~0u,
+        [SPRINT_TOKENIZER_STATE_STATEMENT_TERMINATOR] = ~0u
+};
+
+// The token type produced by every state
+static const sprint_token_type SPRINT_TOKENIZER_STATE_TYPES[] = {
+        [SPRINT_TOKENIZER_STATE_SCANNING] = SPRINT_TOKEN_TYPE_NONE,
+        [SPRINT_TOKENIZER_STATE_INVALID] = SPRINT_TOKEN_TYPE_INVALID,
+        [SPRINT_TOKENIZER_STATE_COMMENT] = SPRINT_TOKEN_TYPE_NONE,
+        [SPRINT_TOKENIZER_STATE_WORD] = SPRINT_TOKEN_TYPE_WORD,
+        [SPRINT_TOKENIZER_STATE_NUMBER] = SPRINT_TOKEN_TYPE_NUMBER,
+        [SPRINT_TOKENIZER_STATE_STRING_START] = SPRINT_TOKEN_TYPE_STRING,
+        [SPRINT_TOKENIZER_STATE_STRING] = SPRINT_TOKEN_TYPE_STRING,
+        [SPRINT_TOKENIZER_STATE_STRING_END] = SPRINT_TOKEN_TYPE_STRING,
+        [SPRINT_TOKENIZER_STATE_VALUE_SEPARATOR] = SPRINT_TOKEN_TYPE_VALUE_SEPARATOR,
+        [SPRINT_TOKENIZER_STATE_TUPLE_SEPARATOR] = SPRINT_TOKEN_TYPE_TUPLE_SEPARATOR,
+        [SPRINT_TOKENIZER_STATE_STATEMENT_SEPARATOR] = SPRINT_TOKEN_TYPE_STATEMENT_SEPARATOR,
+        [SPRINT_TOKENIZER_STATE_STATEMENT_TERMINATOR] = SPRINT_TOKEN_TYPE_STATEMENT_TERMINATOR
+};
+
+// Unchecked lookups for the hot path, which only ever deals with valid states
+#define sprint_tokenizer_state_next_internal(current_state, next_chr) \
+    ((sprint_tokenizer_state) SPRINT_TOKENIZER_STATE_TRANSITIONS[current_state][(unsigned char) (next_chr)])
+#define sprint_tokenizer_state_recorded_internal(state) ((SPRINT_TOKENIZER_STATES_RECORDED >> (state)) & 1u)
+#define sprint_tokenizer_state_complete_internal(current_state, next_state) \
+    ((SPRINT_TOKENIZER_STATE_COMPLETIONS[current_state] >> (next_state)) & 1u)
+#define sprint_tokenizer_state_type_internal(state) (SPRINT_TOKENIZER_STATE_TYPES[state])
+
+// Vector operations for skipping runs of characters, which compare the characters as signed bytes
+#if defined(__AVX2__)
+typedef __m256i sprint_tokenizer_vector;
+#define SPRINT_TOKENIZER_VECTOR_SIZE 32
+#define SPRINT_TOKENIZER_VECTOR_MASK 0xFFFFFFFFu
+#define sprint_tokenizer_vector_load(chrs) _mm256_loadu_si256((const __m256i*) (chrs))
+#define sprint_tokenizer_vector_set(chr) _mm256_set1_epi8((char) (chr))
+#define sprint_tokenizer_vector_eq(vector, chr) _mm256_cmpeq_epi8((vector), sprint_tokenizer_vector_set(chr))
+#define sprint_tokenizer_vector_gt(vector, chr) _mm256_cmpgt_epi8((vector), sprint_tokenizer_vector_set(chr))
+#define sprint_tokenizer_vector_lt(vector, chr) _mm256_cmpgt_epi8(sprint_tokenizer_vector_set(chr), (vector))
+#define sprint_tokenizer_vector_or(first, second) _mm256_or_si256((first), (second))
+#define sprint_tokenizer_vector_and(first, second) _mm256_and_si256((first), (second))
+#define sprint_tokenizer_vector_mask(vector) ((unsigned) _mm256_movemask_epi8(vector))
+#elif defined(__SSE2__)
+typedef __m128i sprint_tokenizer_vector;
+#define SPRINT_TOKENIZER_VECTOR_SIZE 16
+#define SPRINT_TOKENIZER_VECTOR_MASK 0xFFFFu
+#define sprint_tokenizer_vector_load(chrs) _mm_loadu_si128((const __m128i*) (chrs))
+#define sprint_tokenizer_vector_set(chr) _mm_set1_epi8((char) (chr))
+#define sprint_tokenizer_vector_eq(vector, chr) _mm_cmpeq_epi8((vector), sprint_tokenizer_vector_set(chr))
+#define sprint_tokenizer_vector_gt(vector, chr) _mm_cmpgt_epi8((vector), sprint_tokenizer_vector_set(chr))
+#define sprint_tokenizer_vector_lt(vector, chr) _mm_cmplt_epi8((vector), sprint_tokenizer_vector_set(chr))
+#define sprint_tokenizer_vector_or(first, second) _mm_or_si128((first), (second))
+#define sprint_tokenizer_vector_and(first, second) _mm_and_si128((first), (second))
+#define sprint_tokenizer_vector_mask(vector) ((unsigned) _mm_movemask_epi8(vector))
+#endif
 
 bool sprint_tokenizer_state_valid(sprint_tokenizer_state state)
 {
@@ -70,43 +224,7 @@ sprint_tokenizer_state sprint_tokenizer_state_next(sprint_tokenizer_state curren
     if (!sprint_assert(false, sprint_tokenizer_state_valid(current_state)))
         return SPRINT_TOKENIZER_STATE_INVALID;
 
-    // Handle enclosed strings
-    if (current_state == SPRINT_TOKENIZER_STATE_STRING_START || current_state == SPRINT_TOKENIZER_STATE_STRING)
-        return next_chr == SPRINT_STRING_DELIMITER || next_chr == '\n' || next_chr == '\r' ?
-               SPRINT_TOKENIZER_STATE_STRING_END : SPRINT_TOKENIZER_STATE_STRING;
-
-    // Handle comments that end at the end of the line
-    if (current_state == SPRINT_TOKENIZER_STATE_COMMENT && next_chr != '\n' && next_chr != '\r' ||
-        next_chr == SPRINT_COMMENT_PREFIX)
-        return SPRINT_TOKENIZER_STATE_COMMENT;
-
-    // Handle scanning through white-space
-    if (next_chr == ' ' || next_chr == '\t' || next_chr == '\n' || next_chr == '\r')
-        return SPRINT_TOKENIZER_STATE_SCANNING;
-
-    // Handle words
-    if (next_chr >= 'A' && next_chr <= 'Z' || next_chr >= 'a' && next_chr <= 'z' || next_chr == '_')
-        return SPRINT_TOKENIZER_STATE_WORD;
-
-    // Handle numbers
-    if (next_chr >= '0' && next_chr <= '9' || next_chr == '-' && current_state != SPRINT_TOKENIZER_STATE_NUMBER &&
-        current_state != SPRINT_TOKENIZER_STATE_WORD)
-        return SPRINT_TOKENIZER_STATE_NUMBER;
-
-    // Handle the single digit separators, terminators and the string delimiter
-    if (next_chr == SPRINT_VALUE_SEPARATOR)
-        return SPRINT_TOKENIZER_STATE_VALUE_SEPARATOR;
-    if (next_chr == SPRINT_TUPLE_SEPARATOR)
-        return SPRINT_TOKENIZER_STATE_TUPLE_SEPARATOR;
-    if (next_chr == SPRINT_STATEMENT_SEPARATOR)
-        return SPRINT_TOKENIZER_STATE_STATEMENT_SEPARATOR;
-    if (next_chr == SPRINT_STATEMENT_TERMINATOR)
-        return SPRINT_TOKENIZER_STATE_STATEMENT_TERMINATOR;
-    if (next_chr == SPRINT_STRING_DELIMITER)
-        return SPRINT_TOKENIZER_STATE_STRING_START;
-
-    // All other characters are invalid
-    return SPRINT_TOKENIZER_STATE_INVALID;
+    return sprint_tokenizer_state_next_internal(current_state, next_chr);
 }
 
 bool sprint_tokenizer_state_idle(sprint_tokenizer_state state)
@@ -119,27 +237,7 @@ bool sprint_tokenizer_state_recorded(sprint_tokenizer_state state)
     if (!sprint_assert(false, sprint_tokenizer_state_valid(state)))
         return false;
 
-    switch (state) {
-        case SPRINT_TOKENIZER_STATE_INVALID:
-        case SPRINT_TOKENIZER_STATE_WORD:
-        case SPRINT_TOKENIZER_STATE_NUMBER:
-        case SPRINT_TOKENIZER_STATE_STRING:
-        case SPRINT_TOKENIZER_STATE_VALUE_SEPARATOR:
-        case SPRINT_TOKENIZER_STATE_TUPLE_SEPARATOR:
-        case SPRINT_TOKENIZER_STATE_STATEMENT_SEPARATOR:
-        case SPRINT_TOKENIZER_STATE_STATEMENT_TERMINATOR:
-            return true;
-
-        case SPRINT_TOKENIZER_STATE_SCANNING:
-        case SPRINT_TOKENIZER_STATE_COMMENT:
-        case SPRINT_TOKENIZER_STATE_STRING_START:
-        case SPRINT_TOKENIZER_STATE_STRING_END:
-            return false;
-
-        default:
-            sprint_warning_format("unimplemented state: %d", state);
-            return false;
-    }
+    return sprint_tokenizer_state_recorded_internal(state);
 }
 
 bool sprint_tokenizer_state_complete(sprint_tokenizer_state current_state, sprint_tokenizer_state next_state)
@@ -148,29 +246,7 @@ bool sprint_tokenizer_state_complete(sprint_tokenizer_state current_state, sprin
         !sprint_assert(false, sprint_tokenizer_state_valid(next_state)))
         return true;
 
-    switch (current_state) {
-        case SPRINT_TOKENIZER_STATE_SCANNING:
-        case SPRINT_TOKENIZER_STATE_COMMENT:
-        case SPRINT_TOKENIZER_STATE_STRING_START:
-        case SPRINT_TOKENIZER_STATE_STRING:
-            return false;
-
-        case SPRINT_TOKENIZER_STATE_WORD:
-        case SPRINT_TOKENIZER_STATE_NUMBER:
-        case SPRINT_TOKENIZER_STATE_STRING_END:
-            return current_state != next_state;
-
-        case SPRINT_TOKENIZER_STATE_INVALID:
-        case SPRINT_TOKENIZER_STATE_VALUE_SEPARATOR:
-        case SPRINT_TOKENIZER_STATE_TUPLE_SEPARATOR:
-        case SPRINT_TOKENIZER_STATE_STATEMENT_SEPARATOR:
-        case SPRINT_TOKENIZER_STATE_STATEMENT_TERMINATOR:
-            return true;
-
-        default:
-            sprint_warning_format("unimplemented state: %d", current_state);
-            return true;
-    }
+    return sprint_tokenizer_state_complete_internal(current_state, next_state);
 }
 
 sprint_token_type sprint_tokenizer_state_type(sprint_tokenizer_state state)
@@ -178,55 +254,43 @@ sprint_token_type sprint_tokenizer_state_type(sprint_tokenizer_state state)
     if (!sprint_assert(false, sprint_tokenizer_state_valid(state)))
         return SPRINT_TOKEN_TYPE_NONE;
 
-    switch (state) {
-        case SPRINT_TOKENIZER_STATE_SCANNING:
-        case SPRINT_TOKENIZER_STATE_COMMENT:
-            return SPRINT_TOKEN_TYPE_NONE;
-        case SPRINT_TOKENIZER_STATE_INVALID:
-            return SPRINT_TOKEN_TYPE_INVALID;
-        case SPRINT_TOKENIZER_STATE_WORD:
-            return SPRINT_TOKEN_TYPE_WORD;
-        case SPRINT_TOKENIZER_STATE_NUMBER:
-            return SPRINT_TOKEN_TYPE_NUMBER;
-        case SPRINT_TOKENIZER_STATE_STRING_START:
-        case SPRINT_TOKENIZER_STATE_STRING:
-        case SPRINT_TOKENIZER_STATE_STRING_END:
-            return SPRINT_TOKEN_TYPE_STRING;
-        case SPRINT_TOKENIZER_STATE_VALUE_SEPARATOR:
-            return SPRINT_TOKEN_TYPE_VALUE_SEPARATOR;
-        case SPRINT_TOKENIZER_STATE_TUPLE_SEPARATOR:
-            return SPRINT_TOKEN_TYPE_TUPLE_SEPARATOR;
-        case SPRINT_TOKENIZER_STATE_STATEMENT_SEPARATOR:
-            return SPRINT_TOKEN_TYPE_STATEMENT_SEPARATOR;
-        case SPRINT_TOKENIZER_STATE_STATEMENT_TERMINATOR:
-            return SPRINT_TOKEN_TYPE_STATEMENT_TERMINATOR;
-        default:
-            sprint_throw_format(false, "unimplemented state: %d", state);
-            return SPRINT_TOKEN_TYPE_NONE;
-    }
+    return sprint_tokenizer_state_type_internal(state);
 }
 
 sprint_error sprint_token_contents(sprint_token* token, sprint_stringbuilder* builder, char** contents)
 {
     if (token == NULL || builder == NULL || contents == NULL) return SPRINT_ERROR_ARGUMENT_NULL;
 
+    // Locate the contents
+    const char* span;
+    int length;
+    sprint_error error = SPRINT_ERROR_NONE;
+    if (!sprint_chain(error, sprint_token_span(token, builder, &span, &length)))
+        return sprint_rethrow(error);
+
     // Allocate a dynamic buffer
-    size_t size = sprint_stringbuilder_count(builder) + 1;
-    *contents = malloc(size);
+    *contents = malloc(length + 1);
     if (*contents == NULL)
         return SPRINT_ERROR_MEMORY;
 
     // Copy the value
-    sprint_error error = SPRINT_ERROR_NONE;
-    sprint_chain(error, sprint_stringbuilder_output(builder, *contents, size));
-    return sprint_rethrow(error);
+    memcpy(*contents, span, length);
+    (*contents)[length] = 0;
+    return SPRINT_ERROR_NONE;
 }
 
 sprint_error sprint_token_word(sprint_token* token, sprint_stringbuilder* builder, char** word)
 {
     if (token == NULL || builder == NULL || word == NULL) return SPRINT_ERROR_ARGUMENT_NULL;
     if (token->type != SPRINT_TOKEN_TYPE_WORD) return SPRINT_ERROR_ARGUMENT_FORMAT;
-    if (sprint_stringbuilder_count(builder) < 1) return SPRINT_ERROR_ARGUMENT_INCOMPLETE;
+
+    // Locate the contents
+    const char* span;
+    int length;
+    sprint_error error = SPRINT_ERROR_NONE;
+    if (!sprint_chain(error, sprint_token_span(token, builder, &span, &length)))
+        return sprint_rethrow(error);
+    if (length < 1) return SPRINT_ERROR_ARGUMENT_INCOMPLETE;
 
     return sprint_rethrow(sprint_token_contents(token, builder, word));
 }
@@ -235,19 +299,58 @@ sprint_error sprint_token_bool(sprint_token* token, sprint_stringbuilder* builde
 {
     if (token == NULL || builder == NULL || val == NULL) return SPRINT_ERROR_ARGUMENT_NULL;
     if (token->type != SPRINT_TOKEN_TYPE_WORD) return SPRINT_ERROR_ARGUMENT_FORMAT;
-    if (sprint_stringbuilder_count(builder) < 1) return SPRINT_ERROR_ARGUMENT_INCOMPLETE;
 
-    // Copy the value
-    size_t size = sprint_stringbuilder_count(builder) + 1;
-    char buffer[size];
-    sprint_error error = SPRINT_ERROR_NONE;
-    if (!sprint_chain(error, sprint_stringbuilder_output(builder, buffer, size)))
-        return sprint_rethrow(error);
+    // Decode the value directly from the contents, which can always be located after the checks above
+    const char* span;
+    int length;
+    sprint_token_span(token, builder, &span, &length);
+    return sprint_span_bool(span, length, val);
+}
+
+sprint_error sprint_token_int(sprint_token* token, sprint_stringbuilder* builder, int* val)
+{
+    if (token == NULL || builder == NULL || val == NULL) return SPRINT_ERROR_ARGUMENT_NULL;
+    if (token->type != SPRINT_TOKEN_TYPE_NUMBER) return SPRINT_ERROR_ARGUMENT_FORMAT;
+
+    // Decode the value directly from the contents, which can always be located after the checks above
+    const char* span;
+    int length;
+    sprint_token_span(token, builder, &span, &length);
+    return sprint_span_int(span, length, val);
+}
+
+sprint_error sprint_token_str(sprint_token* token, sprint_stringbuilder* builder, char** str)
+{
+    if (token == NULL || builder == NULL || str == NULL) return SPRINT_ERROR_ARGUMENT_NULL;
+    if (token->type != SPRINT_TOKEN_TYPE_STRING) return SPRINT_ERROR_ARGUMENT_FORMAT;
+
+    return sprint_rethrow(sprint_token_contents(token, builder, str));
+}
+
+sprint_error sprint_token_span(sprint_token* token, sprint_stringbuilder* builder, const char** span, int* length)
+{
+    if (token == NULL || builder == NULL || span == NULL || length == NULL) return SPRINT_ERROR_ARGUMENT_NULL;
+
+    // Prefer the span inside the source over the builder
+    if (token->span != NULL) {
+        *span = token->span;
+        *length = token->span_length;
+    } else {
+        *span = builder->content;
+        *length = builder->count;
+    }
+    return SPRINT_ERROR_NONE;
+}
+
+sprint_error sprint_span_bool(const char* span, int length, bool* val)
+{
+    if (span == NULL || val == NULL) return SPRINT_ERROR_ARGUMENT_NULL;
+    if (length < 1) return SPRINT_ERROR_ARGUMENT_INCOMPLETE;
 
-    // Determine the boolean value
-    if (strcasecmp(buffer, SPRINT_TRUE_VALUE) == 0)
+    // Compare the span with both values, ignoring the case
+    if (length == (int) strlen(SPRINT_TRUE_VALUE) && strncasecmp(span, SPRINT_TRUE_VALUE, length) == 0)
         *val = true;
-    else if (strcasecmp(buffer, SPRINT_FALSE_VALUE) == 0)
+    else if (length == (int) strlen(SPRINT_FALSE_VALUE) && strncasecmp(span, SPRINT_FALSE_VALUE, length) == 0)
         *val = false;
     else
         return SPRINT_ERROR_ARGUMENT_FORMAT;
@@ -255,46 +358,50 @@ sprint_error sprint_token_bool(sprint_token* token, sprint_stringbuilder* builde
     return SPRINT_ERROR_NONE;
 }
 
-sprint_error sprint_token_int(sprint_token* token, sprint_stringbuilder* builder, int* val)
+sprint_error sprint_span_int(const char* span, int length, int* val)
 {
-    if (token == NULL || builder == NULL || val == NULL) return SPRINT_ERROR_ARGUMENT_NULL;
-    if (token->type != SPRINT_TOKEN_TYPE_NUMBER) return SPRINT_ERROR_ARGUMENT_FORMAT;
-    if (sprint_stringbuilder_count(builder) < 1) return SPRINT_ERROR_ARGUMENT_INCOMPLETE;
+    if (span == NULL || val == NULL) return SPRINT_ERROR_ARGUMENT_NULL;
+    if (length < 1) return SPRINT_ERROR_ARGUMENT_INCOMPLETE;
 
-    // Copy the value
-    size_t size = sprint_stringbuilder_count(builder) + 1;
-    char buffer[size];
-    sprint_error error = SPRINT_ERROR_NONE;
-    if (!sprint_chain(error, sprint_stringbuilder_output(builder, buffer, size)))
-        return sprint_rethrow(error);
-
-    // Convert the number
-    errno = 0;
-    char* number_end = NULL;
-    long number = strtol(buffer, &number_end, 10);
-    if (errno != 0 || number_end == NULL || *number_end != 0)
+    // Handle the sign, which must be followed by at least one digit
+    bool negative = *span == '-';
+    int index = negative ? 1 : 0;
+    if (index >= length)
         return SPRINT_ERROR_ARGUMENT_FORMAT;
 
+    // Accumulate the digits as a negative number, because its range is larger
+    int number = 0;
+    for (; index < length; index++) {
+        int digit = span[index] - '0';
+        if (digit < 0 || digit > 9)
+            return SPRINT_ERROR_ARGUMENT_FORMAT;
+        if (number < (INT_MIN + digit) / 10)
+            return SPRINT_ERROR_OVERFLOW;
+        number = number * 10 - digit;
+    }
+
+    // Flip the sign for positive numbers, which cannot hold the minimum
+    if (!negative) {
+        if (number == INT_MIN)
+            return SPRINT_ERROR_OVERFLOW;
+        number = -number;
+    }
+
     // Assign the converted number
     *val = number;
     return SPRINT_ERROR_NONE;
 }
 
-sprint_error sprint_token_str(sprint_token* token, sprint_stringbuilder* builder, char** str)
-{
-    if (token == NULL || builder == NULL || str == NULL) return SPRINT_ERROR_ARGUMENT_NULL;
-    if (token->type != SPRINT_TOKEN_TYPE_STRING) return SPRINT_ERROR_ARGUMENT_FORMAT;
-
-    return sprint_rethrow(sprint_token_contents(token, builder, str));
-}
-
 sprint_tokenizer* sprint_tokenizer_from_str(const char* str, bool free)
 {
     if (str == NULL) return NULL;
 
-    // Allocate the tokenizer
+    // Allocate the tokenizer and use the entire string as its block
     sprint_tokenizer* tokenizer = calloc(1, sizeof(*tokenizer));
     tokenizer->str = str;
+    tokenizer->block = tokenizer->block_position = str;
+    tokenizer->block_end = str + strlen(str);
+    tokenizer->persistent = true;
     tokenizer->read = sprint_tokenizer_read_str_internal;
     tokenizer->close = free ? sprint_tokenizer_close_str_internal : NULL;
 
@@ -305,8 +412,13 @@ sprint_tokenizer* sprint_tokenizer_from_file(FILE* stream, const char* path, boo
 {
     if (stream == NULL || path == NULL) return NULL;
 
-    // Allocate the tokenizer
+    // Allocate the tokenizer and the buffer that blocks are read into
     sprint_tokenizer* tokenizer = calloc(1, sizeof(*tokenizer));
+    tokenizer->buffer = malloc(SPRINT_TOKENIZER_BLOCK_SIZE);
+    if (tokenizer->buffer == NULL) {
+        free(tokenizer);
+        return NULL;
+    }
     tokenizer->file = stream;
     tokenizer->read = sprint_tokenizer_read_file_internal;
     tokenizer->close = close ? sprint_tokenizer_close_file_internal : NULL;
@@ -315,58 +427,296 @@ sprint_tokenizer* sprint_tokenizer_from_file(FILE* stream, const char* path, boo
     return tokenizer;
 }
 
+sprint_tokenizer* sprint_tokenizer_from_mmap(const char* path)
+{
+    if (path == NULL) return NULL;
+
+    // Allocate the tokenizer
+    sprint_tokenizer* tokenizer = calloc(1, sizeof(*tokenizer));
+    if (tokenizer == NULL)
+        return NULL;
+
+#ifdef WIN32
+    // Open the file and determine its size, which is only known for regular files, not for pipes or devices
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                              FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    LARGE_INTEGER size;
+    if (file == INVALID_HANDLE_VALUE || GetFileType(file) != FILE_TYPE_DISK || !GetFileSizeEx(file, &size) ||
+        size.QuadPart > INT_MAX) {
+        if (file != INVALID_HANDLE_VALUE)
+            CloseHandle(file);
+        free(tokenizer);
+        return NULL;
+    }
+    tokenizer->mapping.size = (size_t) size.QuadPart;
+
+    // Map the file, unless it is empty, which cannot be mapped
+    if (tokenizer->mapping.size > 0) {
+        HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mapping != NULL) {
+            tokenizer->mapping.address = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            CloseHandle(mapping);
+        }
+    }
+    CloseHandle(file);
+#else
+    // Open the file and determine its size, which is only known for regular files, not for pipes or devices
+    int file = open(path, O_RDONLY);
+    struct stat status;
+    if (file < 0 || fstat(file, &status) != 0 || !S_ISREG(status.st_mode) || status.st_size > INT_MAX) {
+        if (file >= 0)
+            close(file);
+        free(tokenizer);
+        return NULL;
+    }
+    tokenizer->mapping.size = (size_t) status.st_size;
+
+    // Map the file, unless it is empty, which cannot be mapped
+    if (tokenizer->mapping.size > 0) {
+        void* address = mmap(NULL, tokenizer->mapping.size, PROT_READ, MAP_PRIVATE, file, 0);
+        if (address != MAP_FAILED) {
+            tokenizer->mapping.address = address;
+            madvise(address, tokenizer->mapping.size, MADV_SEQUENTIAL);
+        }
+    }
+    close(file);
+#endif
+
+    // Make sure the mapping succeeded
+    if (tokenizer->mapping.size > 0 && tokenizer->mapping.address == NULL) {
+        free(tokenizer);
+        return NULL;
+    }
+
+    // Use the entire mapping as the block, which stays valid until the tokenizer is closed
+    tokenizer->block = tokenizer->block_position = tokenizer->mapping.size > 0 ? tokenizer->mapping.address : "";
+    tokenizer->block_end = tokenizer->block + tokenizer->mapping.size;
+    tokenizer->persistent = true;
+    tokenizer->read = sprint_tokenizer_read_mmap_internal;
+    tokenizer->close = sprint_tokenizer_close_mmap_internal;
+    tokenizer->origin.source = path;
+
+    return tokenizer;
+}
+
+sprint_tokenizer* sprint_tokenizer_from_feed(const char* source)
+{
+    // Allocate the tokenizer, which stays empty until something is fed to it
+    sprint_tokenizer* tokenizer = calloc(1, sizeof(*tokenizer));
+    if (tokenizer == NULL)
+        return NULL;
+    tokenizer->read = sprint_tokenizer_read_feed_internal;
+    tokenizer->origin.source = source;
+
+    return tokenizer;
+}
+
+sprint_error sprint_tokenizer_feed(sprint_tokenizer* tokenizer, const char* bytes, int length)
+{
+    if (tokenizer == NULL || (bytes == NULL && length > 0)) return SPRINT_ERROR_ARGUMENT_NULL;
+    if (length < 0) return SPRINT_ERROR_ARGUMENT_RANGE;
+    if (tokenizer->read != sprint_tokenizer_read_feed_internal || tokenizer->ended)
+        return SPRINT_ERROR_STATE_INVALID;
+
+    // Null signals the end of the input
+    if (bytes == NULL) {
+        tokenizer->ended = true;
+        return SPRINT_ERROR_NONE;
+    }
+
+    // Grow the buffer, if the remainder of the block and the new bytes do not fit
+    int consumed = (int) (tokenizer->block_position - tokenizer->block);
+    int remaining = (int) (tokenizer->block_end - tokenizer->block_position);
+    if (remaining > INT_MAX - length)
+        return SPRINT_ERROR_OVERFLOW;
+    if (remaining + length > tokenizer->buffer_capacity) {
+        int capacity = tokenizer->buffer_capacity > 0 ? tokenizer->buffer_capacity : SPRINT_TOKENIZER_BLOCK_SIZE;
+        while (capacity < remaining + length)
+            capacity = capacity > INT_MAX / 2 ? INT_MAX : capacity * 2;
+        char* buffer = realloc(tokenizer->buffer, capacity);
+        if (buffer == NULL)
+            return SPRINT_ERROR_MEMORY;
+
+        // The block moves along with the buffer
+        tokenizer->buffer = buffer;
+        tokenizer->buffer_capacity = capacity;
+        tokenizer->block = buffer;
+        tokenizer->block_position = buffer + consumed;
+    }
+
+    // Move the remainder to the front and append the new bytes to it
+    memmove(tokenizer->buffer, tokenizer->block_position, remaining);
+    memcpy(tokenizer->buffer + remaining, bytes, length);
+    tokenizer->block_offset += consumed;
+    tokenizer->block = tokenizer->block_position = tokenizer->buffer;
+    tokenizer->block_end = tokenizer->buffer + remaining + length;
+    return SPRINT_ERROR_NONE;
+}
+
+sprint_tokenizer* sprint_tokenizer_from_range(sprint_tokenizer* source, int start, int end)
+{
+    if (source == NULL || !source->persistent || source->block == NULL) return NULL;
+    if (start < 0 || start > end || end > source->block_end - source->block) return NULL;
+
+    // Allocate the tokenizer
+    sprint_tokenizer* tokenizer = calloc(1, sizeof(*tokenizer));
+    if (tokenizer == NULL)
+        return NULL;
+
+    // Use the range as the block, while keeping the offsets relative to the entire source
+    tokenizer->block = tokenizer->block_position = source->block + start;
+    tokenizer->block_end = source->block + end;
+    tokenizer->block_offset = source->block_offset + start;
+    tokenizer->persistent = true;
+    tokenizer->read = sprint_tokenizer_read_range_internal;
+    tokenizer->origin.source = source->origin.source;
+
+    // Positions inside the range can only be resolved against the entire source
+    tokenizer->lazy = true;
+    tokenizer->origin.line = -1;
+    tokenizer->origin.pos = -1;
+
+    return tokenizer;
+}
+
+sprint_error sprint_tokenizer_lazy(sprint_tokenizer* tokenizer, bool lazy)
+{
+    if (tokenizer == NULL) return SPRINT_ERROR_ARGUMENT_NULL;
+    if (tokenizer->preloaded || (lazy && !tokenizer->persistent)) return SPRINT_ERROR_STATE_INVALID;
+
+    // Mark the positions as unresolved, if they are not going to be counted
+    tokenizer->lazy = lazy;
+    tokenizer->origin.line = lazy ? -1 : 0;
+    tokenizer->origin.pos = lazy ? -1 : 0;
+    return SPRINT_ERROR_NONE;
+}
+
+sprint_error sprint_tokenizer_resolve(sprint_tokenizer* tokenizer, sprint_source_origin* origin)
+{
+    if (tokenizer == NULL || origin == NULL) return SPRINT_ERROR_ARGUMENT_NULL;
+
+    // Check, if the origin is already resolved
+    if (origin->line >= 0 && origin->pos >= 0)
+        return SPRINT_ERROR_NONE;
+    if (!tokenizer->lazy || tokenizer->block == NULL)
+        return SPRINT_ERROR_STATE_INVALID;
+
+    // Nothing has been counted before the first character
+    const char* start = tokenizer->block - tokenizer->block_offset;
+    int offset = origin->offset;
+    if (offset < 0) {
+        origin->line = 0;
+        origin->pos = 0;
+        return SPRINT_ERROR_NONE;
+    }
+    if (offset >= tokenizer->block_end - start)
+        return SPRINT_ERROR_ARGUMENT_RANGE;
+
+    // Make sure the line index is built
+    sprint_error error = SPRINT_ERROR_NONE;
+    if (tokenizer->lines == NULL && !sprint_chain(error, sprint_tokenizer_index_internal(tokenizer)))
+        return sprint_rethrow(error);
+
+    // Find the number of lines started up to and including the offset
+    int lower = 0, upper = tokenizer->line_count;
+    while (lower < upper) {
+        int middle = lower + (upper - lower) / 2;
+        if (tokenizer->lines[middle] <= offset)
+            lower = middle + 1;
+        else
+            upper = middle;
+    }
+    origin->line = lower;
+
+    // The position counts the characters after the first one following the last line-ending
+    int last = offset;
+    if (start[offset] != '\n' && start[offset] != '\r')
+        while (last > 0 && start[last - 1] != '\n' && start[last - 1] != '\r')
+            last--;
+    origin->pos = offset - last;
+    return SPRINT_ERROR_NONE;
+}
+
 sprint_error sprint_tokenizer_next(sprint_tokenizer* tokenizer, sprint_token* token, sprint_stringbuilder* builder)
 {
     if (tokenizer == NULL || token == NULL || builder == NULL) return SPRINT_ERROR_ARGUMENT_NULL;
     if (tokenizer->read == NULL) return SPRINT_ERROR_STATE_INVALID;
 
-    // Clear the token
-    memset(token, 0, sizeof(*token));
-
-    // Make sure the builder is empty
+    // Resume a token that was suspended while waiting for input, or otherwise start a new one
     sprint_error error = SPRINT_ERROR_NONE;
-    if (sprint_stringbuilder_count(builder) > 0 && !sprint_chain(error, sprint_stringbuilder_clear(builder)))
-        return sprint_rethrow(error);
+    bool scanning = true;
+    if (tokenizer->suspended) {
+        scanning = tokenizer->scanning;
+        tokenizer->suspended = false;
+    } else {
+        // Clear the token
+        memset(token, 0, sizeof(*token));
+
+        // Make sure the builder is empty
+        if (sprint_stringbuilder_count(builder) > 0 && !sprint_chain(error, sprint_stringbuilder_clear(builder)))
+            return sprint_rethrow(error);
+    }
 
     // Make sure the tokenizer is preloaded by reading the first character and determining the first state
     if (!tokenizer->preloaded && tokenizer->read(tokenizer))
         tokenizer->next_state = sprint_tokenizer_state_first(tokenizer->next_chr);
+    if (tokenizer->starved) {
+        tokenizer->starved = false;
+        return SPRINT_ERROR_UNDERFLOW;
+    }
 
     // Process until reaching EOF
-    bool scanning = true;
     while (!tokenizer->last_eof) {
+        // Scan straight out of the buffered block, as long as there is anything left in it
+        if (tokenizer->block_position < tokenizer->block_end) {
+            bool complete = false;
+            if (!sprint_chain(error, sprint_tokenizer_scan_block_internal(tokenizer, token, builder, &scanning, &complete)))
+                return sprint_rethrow(error);
+            if (complete)
+                return SPRINT_ERROR_NONE;
+
+            // Otherwise, the block is exhausted and the slow path reads across the boundary
+        }
+
         // Move to the next character and state
         char current_chr = tokenizer->next_chr;
         sprint_tokenizer_state current_state = tokenizer->next_state;
 
         // Store the origin, if at a transition
-        if (scanning && sprint_tokenizer_state_type(current_state) != SPRINT_TOKEN_TYPE_NONE) {
-            token->origin = tokenizer->origin;
+        if (scanning && sprint_tokenizer_state_type_internal(current_state) != SPRINT_TOKEN_TYPE_NONE) {
+            sprint_tokenizer_origin_internal(tokenizer, &token->origin);
             scanning = false;
         }
 
-        // Read the next character (ignoring whether it succeeded) and determine the state
+        // Read the next character (ignoring whether it succeeded), unless waiting for input, and determine the state
         tokenizer->read(tokenizer);
-        tokenizer->next_state = sprint_tokenizer_state_next(current_state, tokenizer->next_chr);
+        if (tokenizer->starved) {
+            // Suspend the token at the current character, so that it can be resumed once more input is fed
+            tokenizer->starved = false;
+            tokenizer->suspended = true;
+            tokenizer->scanning = scanning;
+            return SPRINT_ERROR_UNDERFLOW;
+        }
+        tokenizer->next_state = sprint_tokenizer_state_next_internal(current_state, tokenizer->next_chr);
 
         // Decide, whether to record it
-        if (sprint_tokenizer_state_recorded(current_state) &&
+        if (sprint_tokenizer_state_recorded_internal(current_state) &&
             !sprint_chain(error, sprint_stringbuilder_put_chr(builder, current_chr)))
             return sprint_rethrow(error);
 
         // Check, whether the token is complete
-        if (!sprint_tokenizer_state_complete(current_state, tokenizer->next_state))
+        if (!sprint_tokenizer_state_complete_internal(current_state, tokenizer->next_state))
             continue;
 
         // Update the type and return success
-        token->type = sprint_tokenizer_state_type(current_state);
+        token->type = sprint_tokenizer_state_type_internal(current_state);
         return SPRINT_ERROR_NONE;
     }
 
     // If the EOF was reached without finding anything, token an empty token instead of an invalid one
     if (scanning) {
         token->type = SPRINT_TOKEN_TYPE_NONE;
-        token->origin = tokenizer->origin;
+        sprint_tokenizer_origin_internal(tokenizer, &token->origin);
         return SPRINT_ERROR_EOF;
     } else {
         token->type = SPRINT_TOKEN_TYPE_INVALID;
@@ -387,6 +737,14 @@ sprint_error sprint_tokenizer_destroy(sprint_tokenizer* tokenizer)
 
     // Free the memory
     tokenizer->read = NULL;
+    if (tokenizer->buffer != NULL) {
+        free(tokenizer->buffer);
+        tokenizer->buffer = NULL;
+    }
+    if (tokenizer->lines != NULL) {
+        free(tokenizer->lines);
+        tokenizer->lines = NULL;
+    }
     free(tokenizer);
     return success ? SPRINT_ERROR_NONE : SPRINT_ERROR_IO;
 }
@@ -411,46 +769,288 @@ void sprint_tokenizer_count_internal(sprint_tokenizer* tokenizer, char chr)
     tokenizer->last_lf = current_lf;
 }
 
-bool sprint_tokenizer_read_str_internal(sprint_tokenizer* tokenizer)
+const char* sprint_tokenizer_skip_internal(const char* start, const char* end, sprint_tokenizer_state state)
 {
-    if (tokenizer == NULL || tokenizer->str == NULL || tokenizer->last_eof) return false;
+    // Only runs of words, numbers, strings, comments and blanks can be skipped
+    switch (state) {
+        case SPRINT_TOKENIZER_STATE_SCANNING:
+        case SPRINT_TOKENIZER_STATE_COMMENT:
+        case SPRINT_TOKENIZER_STATE_WORD:
+        case SPRINT_TOKENIZER_STATE_NUMBER:
+        case SPRINT_TOKENIZER_STATE_STRING:
+            break;
+
+        default:
+            return start;
+    }
+
+    const char* position = start;
+#ifdef SPRINT_TOKENIZER_VECTOR_SIZE
+    // Determine the characters that end the run a whole vector at a time
+    while (end - position >= SPRINT_TOKENIZER_VECTOR_SIZE) {
+        sprint_tokenizer_vector chrs = sprint_tokenizer_vector_load(position);
+        sprint_tokenizer_vector cr = sprint_tokenizer_vector_eq(chrs, '\r');
+        sprint_tokenizer_vector lf = sprint_tokenizer_vector_eq(chrs, '\n');
+        sprint_tokenizer_vector lower;
+        unsigned stops;
+        switch (state) {
+            case SPRINT_TOKENIZER_STATE_SCANNING:
+                // Line-endings are left to the character-wise path, which counts them
+                stops = ~sprint_tokenizer_vector_mask(sprint_tokenizer_vector_or(
+                        sprint_tokenizer_vector_eq(chrs, ' '), sprint_tokenizer_vector_eq(chrs, '\t')));
+                break;
+
+            case SPRINT_TOKENIZER_STATE_COMMENT:
+                stops = sprint_tokenizer_vector_mask(sprint_tokenizer_vector_or(cr, lf));
+                break;
+
+            case SPRINT_TOKENIZER_STATE_WORD:
+                // Letters are folded to lower-case, while all non-ASCII characters compare as negative
+                lower = sprint_tokenizer_vector_or(chrs, sprint_tokenizer_vector_set(0x20));
+                stops = ~sprint_tokenizer_vector_mask(sprint_tokenizer_vector_or(
+                        sprint_tokenizer_vector_and(sprint_tokenizer_vector_gt(lower, 'a' - 1),
+                                                    sprint_tokenizer_vector_lt(lower, 'z' + 1)),
+                        sprint_tokenizer_vector_eq(chrs, '_')));
+                break;
+
+            case SPRINT_TOKENIZER_STATE_NUMBER:
+                stops = ~sprint_tokenizer_vector_mask(sprint_tokenizer_vector_and(
+                        sprint_tokenizer_vector_gt(chrs, '0' - 1), sprint_tokenizer_vector_lt(chrs, '9' + 1)));
+                break;
+
+            default:
+                stops = sprint_tokenizer_vector_mask(sprint_tokenizer_vector_or(
+                        sprint_tokenizer_vector_or(cr, lf), sprint_tokenizer_vector_eq(chrs, '|')));
+                break;
+        }
+
+        // Stop at the first character that ends the run
+        stops &= SPRINT_TOKENIZER_VECTOR_MASK;
+        if (stops != 0)
+            return position + __builtin_ctz(stops);
+        position += SPRINT_TOKENIZER_VECTOR_SIZE;
+    }
+#endif
+
+    // Handle the remainder one character at a time, which must stop at exactly the same characters
+    while (position < end && *position != '\n' && *position != '\r' &&
+           sprint_tokenizer_state_next_internal(state, *position) == state)
+        position++;
+    return position;
+}
+
+void sprint_tokenizer_count_run_internal(sprint_tokenizer* tokenizer, int count)
+{
+    // None of the characters are line-endings, so only the first one can follow a line-ending
+    tokenizer->origin.pos += count - (tokenizer->last_cr | tokenizer->last_lf);
+    tokenizer->last_cr = false;
+    tokenizer->last_lf = false;
+}
+
+void sprint_tokenizer_origin_internal(sprint_tokenizer* tokenizer, sprint_source_origin* origin)
+{
+    // The current character is the last one read from the block
+    *origin = tokenizer->origin;
+    origin->offset = tokenizer->block_offset + (int) (tokenizer->block_position - tokenizer->block) - 1;
+}
+
+sprint_error sprint_tokenizer_index_internal(sprint_tokenizer* tokenizer)
+{
+    // Allocate the index of the offsets that start a new line
+    int capacity = 64, count = 0;
+    int* lines = malloc(capacity * sizeof(*lines));
+    if (lines == NULL)
+        return SPRINT_ERROR_MEMORY;
+
+    // Collect every carriage return and every line feed that does not follow one
+    const char* start = tokenizer->block - tokenizer->block_offset;
+    int length = (int) (tokenizer->block_end - start);
+    for (int offset = 0; offset < length; offset++) {
+        if (start[offset] != '\r' && (start[offset] != '\n' || (offset > 0 && start[offset - 1] == '\r')))
+            continue;
+
+        // Grow the index if needed
+        if (count >= capacity) {
+            capacity *= 2;
+            int* grown = realloc(lines, capacity * sizeof(*lines));
+            if (grown == NULL) {
+                free(lines);
+                return SPRINT_ERROR_MEMORY;
+            }
+            lines = grown;
+        }
+        lines[count++] = offset;
+    }
 
-    // Read the character and check, if the EOF is reached
-    char chr = *tokenizer->str;
-    if (chr == 0) {
+    tokenizer->lines = lines;
+    tokenizer->line_count = count;
+    return SPRINT_ERROR_NONE;
+}
+
+sprint_error sprint_tokenizer_scan_block_internal(sprint_tokenizer* tokenizer, sprint_token* token,
+                                                  sprint_stringbuilder* builder, bool* scanning, bool* complete)
+{
+    // The current character is only located inside the block, if something has already been read from it
+    bool current_in_block = tokenizer->block_position > tokenizer->block;
+
+    // The recorded characters of a token are contiguous, so keep track of their range instead of copying each one
+    const char* record_start = NULL;
+    const char* record_end = NULL;
+
+    // Process until reaching the end of the block
+    sprint_error error = SPRINT_ERROR_NONE;
+    while (tokenizer->block_position < tokenizer->block_end) {
+        // Move to the next character and state
+        const char* current_position = tokenizer->block_position - 1;
+        char current_chr = tokenizer->next_chr;
+        sprint_tokenizer_state current_state = tokenizer->next_state;
+
+        // Store the origin, if at a transition
+        if (*scanning && sprint_tokenizer_state_type_internal(current_state) != SPRINT_TOKEN_TYPE_NONE) {
+            sprint_tokenizer_origin_internal(tokenizer, &token->origin);
+            *scanning = false;
+        }
+
+        // Skip the rest of a run of characters in the same state, making its last character the current one
+        if (current_in_block || !sprint_tokenizer_state_recorded_internal(current_state)) {
+            const char* run_end = sprint_tokenizer_skip_internal(tokenizer->block_position, tokenizer->block_end,
+                                                                 current_state);
+            if (run_end > tokenizer->block_position) {
+                if (sprint_tokenizer_state_recorded_internal(current_state)) {
+                    if (record_start == NULL)
+                        record_start = current_position;
+                    record_end = run_end - 1;
+                }
+                if (!tokenizer->lazy)
+                    sprint_tokenizer_count_run_internal(tokenizer, (int) (run_end - tokenizer->block_position));
+                tokenizer->block_position = run_end;
+                tokenizer->next_chr = run_end[-1];
+                current_position = run_end - 1;
+                current_chr = run_end[-1];
+                current_in_block = true;
+
+                // The run may have reached the end of the block
+                if (tokenizer->block_position >= tokenizer->block_end)
+                    break;
+            }
+        }
+
+        // Read the next character directly from the block and determine the state
+        char next_chr = *tokenizer->block_position++;
+        if (!tokenizer->lazy)
+            sprint_tokenizer_count_internal(tokenizer, next_chr);
+        tokenizer->next_chr = next_chr;
+        tokenizer->next_state = sprint_tokenizer_state_next_internal(current_state, next_chr);
+
+        // Decide, whether to record it
+        if (sprint_tokenizer_state_recorded_internal(current_state)) {
+            if (current_in_block) {
+                if (record_start == NULL)
+                    record_start = current_position;
+                record_end = current_position + 1;
+            } else if (!sprint_chain(error, sprint_stringbuilder_put_chr(builder, current_chr)))
+                return sprint_rethrow(error);
+        }
+        current_in_block = true;
+
+        // Check, whether the token is complete
+        if (!sprint_tokenizer_state_complete_internal(current_state, tokenizer->next_state))
+            continue;
+
+        // Update the type and stop
+        token->type = sprint_tokenizer_state_type_internal(current_state);
+        *complete = true;
+        break;
+    }
+
+    // Reference the recorded range, if the block holds all of the contents of the token
+    if (record_start == NULL)
+        return sprint_rethrow(error);
+    if (*complete && sprint_stringbuilder_count(builder) == 0) {
+        token->span = record_start;
+        token->span_length = (int) (record_end - record_start);
+        return sprint_rethrow(error);
+    }
+
+    // Otherwise, copy the recorded range at once
+    sprint_chain(error, sprint_stringbuilder_put_bytes(builder, record_start, (int) (record_end - record_start)));
+    return sprint_rethrow(error);
+}
+
+bool sprint_tokenizer_read_block_internal(sprint_tokenizer* tokenizer)
+{
+    // Check, if the end of the block is reached
+    if (tokenizer->block_position >= tokenizer->block_end) {
         // If so, store a new line, set the EOF flag and fail
         tokenizer->next_chr = '\n';
         tokenizer->last_eof = true;
         return false;
     }
 
-    // Increment the pointer
-    tokenizer->str++;
+    // Read the character and increment the position
+    char chr = *tokenizer->block_position++;
 
-    // Count and store the character
-    sprint_tokenizer_count_internal(tokenizer, chr);
+    // Count and store the character, unless only the offset is tracked
+    if (tokenizer->lazy)
+        tokenizer->preloaded = true;
+    else
+        sprint_tokenizer_count_internal(tokenizer, chr);
     tokenizer->next_chr = chr;
     return true;
 }
 
+bool sprint_tokenizer_read_str_internal(sprint_tokenizer* tokenizer)
+{
+    if (tokenizer == NULL || tokenizer->str == NULL || tokenizer->last_eof) return false;
+
+    // The entire string is a single block
+    return sprint_tokenizer_read_block_internal(tokenizer);
+}
+
 bool sprint_tokenizer_read_file_internal(sprint_tokenizer* tokenizer)
 {
     if (tokenizer == NULL || tokenizer->file == NULL || tokenizer->last_eof) return false;
 
-    // Read the character and check, if the EOF is reached
-    int raw_chr = fgetc(tokenizer->file);
-    if (raw_chr == EOF) {
-        // If so, store a new line, set the EOF flag and fail
-        tokenizer->next_chr = '\n';
-        tokenizer->last_eof = true;
+    // Refill the buffer with the next block, if the current one is exhausted
+    if (tokenizer->block_position >= tokenizer->block_end) {
+        tokenizer->block_offset += (int) (tokenizer->block_end - tokenizer->block);
+        size_t count = fread(tokenizer->buffer, sizeof(char), SPRINT_TOKENIZER_BLOCK_SIZE, tokenizer->file);
+        tokenizer->block = tokenizer->block_position = tokenizer->buffer;
+        tokenizer->block_end = tokenizer->buffer + count;
+    }
+
+    // Read from the block, which stays empty at the EOF
+    return sprint_tokenizer_read_block_internal(tokenizer);
+}
+
+bool sprint_tokenizer_read_mmap_internal(sprint_tokenizer* tokenizer)
+{
+    if (tokenizer == NULL || tokenizer->last_eof) return false;
+
+    // The entire mapping is a single block
+    return sprint_tokenizer_read_block_internal(tokenizer);
+}
+
+bool sprint_tokenizer_read_range_internal(sprint_tokenizer* tokenizer)
+{
+    if (tokenizer == NULL || tokenizer->last_eof) return false;
+
+    // The range is a single block inside of the source, which owns it
+    return sprint_tokenizer_read_block_internal(tokenizer);
+}
+
+bool sprint_tokenizer_read_feed_internal(sprint_tokenizer* tokenizer)
+{
+    if (tokenizer == NULL || tokenizer->last_eof) return false;
+
+    // Wait for more input, unless the end of the input has been fed
+    if (tokenizer->block_position >= tokenizer->block_end && !tokenizer->ended) {
+        tokenizer->starved = true;
         return false;
     }
-    char chr = (char) raw_chr;
 
-    // Count and store the character
-    sprint_tokenizer_count_internal(tokenizer, chr);
-    tokenizer->next_chr = chr;
-    return true;
+    // Read from the block, which stays empty at the EOF
+    return sprint_tokenizer_read_block_internal(tokenizer);
 }
 
 bool sprint_tokenizer_close_str_internal(sprint_tokenizer* tokenizer)
@@ -471,3 +1071,18 @@ bool sprint_tokenizer_close_file_internal(sprint_tokenizer* tokenizer)
     }
     return success;
 }
+
+bool sprint_tokenizer_close_mmap_internal(sprint_tokenizer* tokenizer)
+{
+    bool success = true;
+    if (tokenizer->mapping.address != NULL) {
+#ifdef WIN32
+        success = UnmapViewOfFile(tokenizer->mapping.address) != 0;
+#else
+        success = munmap(tokenizer->mapping.address, tokenizer->mapping.size) == 0;
+#endif
+        tokenizer->mapping.address = NULL;
+    }
+    tokenizer->block = tokenizer->block_position = tokenizer->block_end = NULL;
+    return success;
+}
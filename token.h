@@ -58,16 +58,24 @@ extern const char SPRINT_TUPLE_SEPARATOR;
 extern const char SPRINT_STRING_DELIMITER;
 extern const char* SPRINT_TRUE_VALUE;
 extern const char* SPRINT_FALSE_VALUE;
+extern const int SPRINT_TOKENIZER_BLOCK_SIZE;
 
 typedef struct sprint_source_origin {
+    // The line and position, or negative if they have not been resolved from the offset yet
     int line;
     int pos;
+    // The byte offset inside the source
+    int offset;
     const char* source;
 } sprint_source_origin;
 
 typedef struct sprint_token {
     sprint_token_type type;
     sprint_source_origin origin;
+    // The contents referenced directly inside the source, or null if they are in the builder.
+    // They remain valid until the next token is read, or for the lifetime of a persistent source.
+    const char* span;
+    int span_length;
 } sprint_token;
 
 sprint_error sprint_token_contents(sprint_token* token, sprint_stringbuilder* builder, char** contents);
@@ -75,6 +83,17 @@ sprint_error sprint_token_word(sprint_token* token, sprint_stringbuilder* builde
 sprint_error sprint_token_bool(sprint_token* token, sprint_stringbuilder* builder, bool* val);
 sprint_error sprint_token_int(sprint_token* token, sprint_stringbuilder* builder, int* val);
 sprint_error sprint_token_str(sprint_token* token, sprint_stringbuilder* builder, char** str);
+/**
+ * Locates the contents of a token without copying them.
+ * @param token The token to locate the contents of.
+ * @param builder The builder that the token was read with.
+ * @param span The target reference to write the start of the contents to, which are not null-terminated.
+ * @param length The target reference to write the length of the contents to.
+ * @return No error returned on success.
+ */
+sprint_error sprint_token_span(sprint_token* token, sprint_stringbuilder* builder, const char** span, int* length);
+sprint_error sprint_span_bool(const char* span, int length, bool* val);
+sprint_error sprint_span_int(const char* span, int length, int* val);
 
 typedef struct sprint_tokenizer sprint_tokenizer;
 
@@ -86,22 +105,87 @@ struct sprint_tokenizer {
     bool last_eof;
     char next_chr;
     sprint_tokenizer_state next_state;
+    const char* block;
+    const char* block_position;
+    const char* block_end;
+    int block_offset;
+    bool persistent;
+    char* buffer;
+    int buffer_capacity;
+    bool ended;
+    bool starved;
+    bool suspended;
+    bool scanning;
+    bool lazy;
+    int* lines;
+    int line_count;
     bool (*read)(sprint_tokenizer* tokenizer);
     bool (*close)(sprint_tokenizer* tokenizer);
     union {
         const char* str;
         FILE* file;
+        struct {
+            void* address;
+            size_t size;
+        } mapping;
     };
 };
 
 sprint_tokenizer* sprint_tokenizer_from_str(const char* str, bool free);
 sprint_tokenizer* sprint_tokenizer_from_file(FILE* stream, const char* path, bool close);
+/**
+ * Creates a tokenizer that maps the file read-only into memory, so that tokens can reference it directly.
+ * @param path The path of the file to map.
+ * @return The tokenizer, or null if the file could not be mapped, e.g. because it is a pipe or a device.
+ */
+sprint_tokenizer* sprint_tokenizer_from_mmap(const char* path);
+/**
+ * Creates a tokenizer that is pushed its input in pieces of any size using sprint_tokenizer_feed.
+ * @param source The name of the source for diagnostics, or null.
+ * @return The tokenizer, or null if it could not be allocated.
+ */
+sprint_tokenizer* sprint_tokenizer_from_feed(const char* source);
+/**
+ * Pushes more input to a tokenizer created by sprint_tokenizer_from_feed, which copies the bytes.
+ * This invalidates the span of the last token.
+ * @param tokenizer The tokenizer instance.
+ * @param bytes The bytes to append to the input, or null to signal the end of the input.
+ * @param length The number of bytes.
+ * @return No error returned on success.
+ */
+sprint_error sprint_tokenizer_feed(sprint_tokenizer* tokenizer, const char* bytes, int length);
+/**
+ * Creates a tokenizer over a range of a persistent source, which must outlive it.
+ * Origins are tracked lazily and relative to the entire source, so they can be resolved by this tokenizer.
+ * @param source The tokenizer of the entire source, regardless of how far it has been read.
+ * @param start The offset of the range inside the source.
+ * @param end The offset of the end of the range inside the source (exclusive).
+ * @return The tokenizer, or null if the source is not persistent or the range is out of bounds.
+ */
+sprint_tokenizer* sprint_tokenizer_from_range(sprint_tokenizer* source, int start, int end);
+/**
+ * Switches the tokenizer to only track byte offsets, leaving line and position to be resolved on demand.
+ * This is only supported for sources that remain addressable in their entirety, before reading from them.
+ * @param tokenizer The tokenizer instance.
+ * @param lazy Whether to resolve positions lazily.
+ * @return No error returned on success.
+ */
+sprint_error sprint_tokenizer_lazy(sprint_tokenizer* tokenizer, bool lazy);
+/**
+ * Resolves the line and position of an origin from its offset, if they are not known yet.
+ * @param tokenizer The tokenizer that the origin was read from.
+ * @param origin The origin to resolve.
+ * @return No error returned on success.
+ */
+sprint_error sprint_tokenizer_resolve(sprint_tokenizer* tokenizer, sprint_source_origin* origin);
 /**
  * Reads the next token from the tokenizer.
  * @param tokenizer The tokenizer instance.
  * @param token The target reference to write the read token to.
  * @param builder The builder to write the contents of the token to.
  * @return No error returned on success. At the end of input, returns EOF or truncated.
+ *         If a fed tokenizer runs out of input, returns underflow, after which the same token and builder must be
+ *         passed again once more input has been fed, to resume the token.
  */
 sprint_error sprint_tokenizer_next(sprint_tokenizer* tokenizer, sprint_token* token, sprint_stringbuilder* builder);
 sprint_error sprint_tokenizer_destroy(sprint_tokenizer* tokenizer);
@@ -0,0 +1,171 @@
+//
+// SprintTrace: parallel element writer
+// Copyright 2022, Laminoid.com (Muessig & Muessig GbR).
+// Licensed under the terms and conditions of the GPLv3.
+//
+
+#include "writer.h"
+#include "loader.h"
+#include "elements.h"
+#include "storage.h"
+#include "primitives.h"
+#include "output.h"
+#include "errors.h"
+
+#include <stdbool.h>
+#include <string.h>
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+const int SPRINT_WRITER_CHUNK_SIZE = 4096;
+
+typedef struct sprint_writer_chunk {
+    // The range of elements to format
+    sprint_storage* elements;
+    int start;
+    int count;
+    sprint_prim_format format;
+
+    // The output that the elements are formatted into
+    sprint_output* buffer;
+
+    // The status of formatting the chunk
+    sprint_error error;
+} sprint_writer_chunk;
+
+static sprint_error sprint_writer_output_sequential_internal(sprint_storage* elements, int start, int count,
+                                                             sprint_output* output, sprint_prim_format format);
+static void sprint_writer_run_internal(sprint_writer_chunk* chunk);
+
+#ifdef WIN32
+static DWORD WINAPI sprint_writer_thread_internal(LPVOID chunk)
+{
+    sprint_writer_run_internal(chunk);
+    return 0;
+}
+#else
+static void* sprint_writer_thread_internal(void* chunk)
+{
+    sprint_writer_run_internal(chunk);
+    return NULL;
+}
+#endif
+
+sprint_error sprint_writer_output(sprint_storage* elements, int threads, sprint_output* output,
+                                  sprint_prim_format format)
+{
+    if (elements == NULL || output == NULL) return SPRINT_ERROR_ARGUMENT_NULL;
+    if (threads < 0) return SPRINT_ERROR_ARGUMENT_RANGE;
+
+    // Only split if there are enough elements for every thread
+    int count = elements->count;
+    if (threads == 0)
+        threads = sprint_loader_threads();
+    if (threads > count / SPRINT_WRITER_CHUNK_SIZE)
+        threads = count / SPRINT_WRITER_CHUNK_SIZE;
+    if (threads > SPRINT_LOADER_THREADS_MAX)
+        threads = SPRINT_LOADER_THREADS_MAX;
+    if (threads < 2)
+        return sprint_rethrow(sprint_writer_output_sequential_internal(elements, 0, count, output, format));
+
+    // Split the elements into contiguous ranges of about the same size
+    sprint_writer_chunk chunks[threads];
+    memset(chunks, 0, sizeof(chunks));
+    for (int index = 0; index < threads; index++) {
+        int start = (int) ((long long) count * index / threads);
+        int end = (int) ((long long) count * (index + 1) / threads);
+        chunks[index].elements = elements;
+        chunks[index].start = start;
+        chunks[index].count = end - start;
+        chunks[index].format = format;
+    }
+
+    // Format all chunks but the first one on their own threads, falling back to this one if they cannot be started
+#ifdef WIN32
+    HANDLE handles[threads];
+#else
+    pthread_t handles[threads];
+#endif
+    bool started[threads];
+    for (int index = 1; index < threads; index++) {
+#ifdef WIN32
+        handles[index] = CreateThread(NULL, 0, sprint_writer_thread_internal, &chunks[index], 0, NULL);
+        started[index] = handles[index] != NULL;
+#else
+        started[index] = pthread_create(&handles[index], NULL, sprint_writer_thread_internal, &chunks[index]) == 0;
+#endif
+        if (!started[index])
+            sprint_writer_run_internal(&chunks[index]);
+    }
+    sprint_writer_run_internal(&chunks[0]);
+
+    // Wait for the threads to complete
+    for (int index = 1; index < threads; index++) {
+        if (!started[index])
+            continue;
+#ifdef WIN32
+        WaitForSingleObject(handles[index], INFINITE);
+        CloseHandle(handles[index]);
+#else
+        pthread_join(handles[index], NULL);
+#endif
+    }
+
+    // Write the chunks in order, until one of them could not be formatted
+    sprint_error error = SPRINT_ERROR_NONE;
+    int index = 0;
+    for (; index < threads && chunks[index].error == SPRINT_ERROR_NONE; index++)
+        if (!sprint_chain(error, sprint_output_put_rope(output, chunks[index].buffer->rope)))
+            break;
+
+    // Then output the rest sequentially, which reproduces the exact diagnostics
+    if (error == SPRINT_ERROR_NONE && index < threads) {
+        int start = chunks[index].start;
+        error = sprint_writer_output_sequential_internal(elements, start, count - start, output, format);
+    }
+
+    // Release the buffers
+    for (index = 0; index < threads; index++)
+        if (chunks[index].buffer != NULL)
+            sprint_check(sprint_output_destroy(chunks[index].buffer, NULL));
+    return sprint_rethrow(error);
+}
+
+sprint_error sprint_writer_output_sequential_internal(sprint_storage* elements, int start, int count,
+                                                      sprint_output* output, sprint_prim_format format)
+{
+    sprint_storage_iterator iterator;
+    sprint_error error = sprint_storage_begin(elements, start, count, &iterator);
+    if (error != SPRINT_ERROR_NONE)
+        return sprint_rethrow(error);
+
+    // Output all elements, stopping at the first one that fails
+    sprint_element* element;
+    while (sprint_storage_next(&iterator, &element))
+        if (!sprint_chain(error, sprint_element_output(element, output, format)))
+            break;
+    return sprint_rethrow(error);
+}
+
+void sprint_writer_run_internal(sprint_writer_chunk* chunk)
+{
+    // Create the buffer, which grows in segments instead of moving what has been formatted already
+    chunk->buffer = sprint_output_create_rope();
+    if (chunk->buffer == NULL) {
+        chunk->error = SPRINT_ERROR_MEMORY;
+        return;
+    }
+
+    // Format all elements of the chunk, which is tentative, so keep the diagnostics of this thread from being emitted
+    bool muted = sprint_error_mute(true);
+    sprint_storage_iterator iterator;
+    sprint_element* element;
+    chunk->error = sprint_storage_begin(chunk->elements, chunk->start, chunk->count, &iterator);
+    while (chunk->error == SPRINT_ERROR_NONE && sprint_storage_next(&iterator, &element))
+        chunk->error = sprint_element_output(element, chunk->buffer, chunk->format);
+    sprint_error_mute(muted);
+}
@@ -0,0 +1,31 @@
+//
+// SprintTrace: parallel element writer
+// Copyright 2022, Laminoid.com (Muessig & Muessig GbR).
+// Licensed under the terms and conditions of the GPLv3.
+//
+
+#ifndef SPRINTTRACE_WRITER_H
+#define SPRINTTRACE_WRITER_H
+
+#include "elements.h"
+#include "storage.h"
+#include "primitives.h"
+#include "output.h"
+#include "errors.h"
+
+extern const int SPRINT_WRITER_CHUNK_SIZE;
+
+/**
+ * Outputs elements in order, which is exactly the same as outputting them one after another.
+ * Many elements are split into contiguous ranges, which are formatted into separate buffers on separate threads.
+ * If any range fails, the elements are output sequentially from that range on, which reproduces the diagnostics.
+ * @param elements The storage of the elements to output.
+ * @param threads The maximum number of threads, or zero to use the default.
+ * @param output The output to write the elements to.
+ * @param format The format to output the elements in.
+ * @return No error returned on success. Otherwise, returns the error of the first element that failed.
+ */
+sprint_error sprint_writer_output(sprint_storage* elements, int threads, sprint_output* output,
+                                  sprint_prim_format format);
+
+#endif //SPRINTTRACE_WRITER_H